@@ -1,12 +1,13 @@
 #include "app/terminal.h"
 #include "target/cfg.h"
-#include "common/log.h"
 #include "kernel/syscall.h"
 #include "lib/parser.h"
 #include "fs/fs.h"
 
 #define TERMINAL_INPUT_BUFFER_SIZE  0x40
 
+#define TERMINAL_OUTPUT_BUFFER_SIZE 0x100
+
 #define PROMPT_PREFIX  "luna "
 #define PROMPT_POSTFIX ">"
 
@@ -16,11 +17,12 @@ extern terminal_command_context _terminal_start;
 extern terminal_command_context _terminal_end;
 
 static const usart_config stdio_config = {
-    .baud_rate   = DEFAULT_BAUD_RATE,
-    .buffer_size = TERMINAL_INPUT_BUFFER_SIZE,
-    .port        = USART2_PORT,
-    .tx_pin      = USART2_TX_PIN,
-    .rx_pin      = USART2_RX_PIN,
+    .baud_rate      = DEFAULT_BAUD_RATE,
+    .buffer_size    = TERMINAL_INPUT_BUFFER_SIZE,
+    .tx_buffer_size = TERMINAL_OUTPUT_BUFFER_SIZE,
+    .port           = USART2_PORT,
+    .tx_pin         = USART2_TX_PIN,
+    .rx_pin         = USART2_RX_PIN,
 };
 
 static usart_iface *stdio = NULL;
@@ -79,8 +81,9 @@ static void terminal_loop(void) {
         const char *cmd_buffer = stdio->buffer_drain(stdio);
         if (strlen(cmd_buffer) > 0 &&
             terminal_process_command(cmd_buffer) != 0) {
-            LOG_ERR("Invalid command/arguments. "
-                    "Type \"help\" for list of available commands.");
+            //! printed right away, queued log would land after the prompt
+            printf("Invalid command/arguments. "
+                   "Type \"help\" for list of available commands.\n");
         }
         terminal_new_cmd();
         stdio->set_buffer_locked(stdio, 0);
@@ -23,6 +23,7 @@
 #define NVIC_BASE                           0xe000e100
 #define SCB_BASE2                           0xe000e008
 #define NVIC_BASE2                          0xe000ef00
+#define DWT_BASE                            0xe0001000
 
 //! STK
 #define STK_CSR                             REGISTER_32(STK_BASE + 0)
@@ -43,6 +44,13 @@
 #define HFSR                                REGISTER_32(SCB_BASE + 0x2C)
 #define BFAR                                REGISTER_32(SCB_BASE + 0x38)
 
+//! debug exception and monitor control
+#define DEMCR                               REGISTER_32(0xe000edfc)
+
+//! DWT
+#define DWT_CTRL                            REGISTER_32(DWT_BASE + 0)
+#define DWT_CYCCNT                          REGISTER_32(DWT_BASE + 4)
+
 //! NVIC
 #define ISER_BASE                           NVIC_BASE + 0x000
 #define ICER_BASE                           NVIC_BASE + 0x080
@@ -51,4 +59,55 @@
 #define IABR_BASE                           NVIC_BASE + 0x200
 #define IPR_BASE                            NVIC_BASE + 0x300
 
+/**
+ * @brief      mask interrupts (privileged code only)
+ *
+ * @return     previous mask state (for core_irq_restore)
+ */
+static inline
+uint32_t core_irq_save(void) {
+    uint32_t primask;
+
+    asm volatile(
+        "mrs %0, primask                     \n\t"
+        "cpsid i                             \n\t"
+        : "=r" (primask) : : "memory"
+    );
+
+    return primask;
+}
+
+/**
+ * @brief      restore interrupt mask saved by core_irq_save
+ */
+static inline
+void core_irq_restore(uint32_t primask) {
+    asm volatile("msr primask, %0" : : "r" (primask) : "memory");
+}
+
+/**
+ * @brief      check if CPU runs exception handler
+ */
+static inline
+int core_handler_mode(void) {
+    uint32_t ipsr;
+
+    asm volatile("mrs %0, ipsr" : "=r" (ipsr));
+
+    return ipsr != 0;
+}
+
+/**
+ * @brief      check if current code may access system registers (handler
+ *             mode or privileged thread mode)
+ */
+static inline
+int core_privileged(void) {
+    uint32_t control;
+
+    asm volatile("mrs %0, control" : "=r" (control));
+
+    return core_handler_mode() || !(control & BIT0);
+}
+
 #endif
@@ -2,6 +2,68 @@
 #define ARCH_CORE_HANDLER_H
 
 #include "common/common.h"
+#include "arch/core.h"
+
+/**
+ * interrupt handlers with duration statistics
+ */
+typedef enum isr_id_t {
+    ISR_SYSTICK                 = 0x00,
+    ISR_USART                   = 0x01,
+    ISR_SPI_DMA                 = 0x02,
+    ISR_ID_MAX,
+} isr_id;
+
+typedef struct isr_stat_t {
+    uint32_t               count;
+    /**
+     * worst case duration in CPU cycles
+     */
+    uint32_t               max;
+} isr_stat;
+
+extern isr_stat isr_stats[ISR_ID_MAX];
+
+/**
+ * @brief      start measuring handler duration
+ *
+ * @return     start timestamp
+ */
+static inline
+uint32_t isr_enter(void) {
+    return DWT_CYCCNT;
+}
+
+/**
+ * @brief      account handler duration
+ *
+ * @param[in]  id     handler id
+ * @param[in]  start  timestamp returned by isr_enter
+ */
+static inline
+void isr_exit(isr_id id, uint32_t start) {
+    uint32_t elapsed = DWT_CYCCNT - start;
+
+    isr_stats[id].count++;
+    if (elapsed > isr_stats[id].max) {
+        isr_stats[id].max = elapsed;
+    }
+}
+
+/**
+ * @brief      get handler statistics
+ *
+ * @param[in]  id    handler id
+ * @param      stat  statistics (output)
+ *
+ * @return     0 in case of success, otherwise negative
+ */
+int isr_stat_get(isr_id id, isr_stat *stat);
+
+/**
+ * @brief      reset handler statistics
+ */
+void isr_stat_reset(void);
 
 /**
  * @brief      Handler for unused interrupts
@@ -3,6 +3,8 @@
 
 #include "common/def.h"
 #include "kernel/thread.h"
+#include "lib/io_vec.h"
+#include "kernel/ted.h"
 
 /**
  * supervisor call codes enumeration
@@ -84,8 +86,91 @@ typedef enum sv_code_t {
      * signal thread to unlock
      */
     SVC_WAKEUP                  = 0x12,
+    /**
+     * loan writable region of descriptor buffer
+     */
+    SVC_WRITE_RESERVE           = 0x13,
+    /**
+     * publish data written to loaned region
+     */
+    SVC_WRITE_COMMIT            = 0x14,
+    /**
+     * loan readable region of descriptor buffer
+     */
+    SVC_READ_PEEK               = 0x15,
+    /**
+     * release data read from loaned region
+     */
+    SVC_READ_RELEASE            = 0x16,
+    /**
+     * write data from several buffers
+     */
+    SVC_WRITEV                  = 0x17,
+    /**
+     * read data into several buffers
+     */
+    SVC_READV                   = 0x18,
+    /**
+     * execute queued requests in one call
+     */
+    SVC_SUBMIT                  = 0x19,
+    /**
+     * arm/cancel tick timer
+     */
+    SVC_TIMER_START             = 0x1a,
+    SVC_TIMER_CANCEL            = 0x1b,
 } sv_code;
 
+/**
+ * fast supervisor call codes: passed in SVC immediate, arguments in
+ * r0-r3, result in r0 (immediate 0 is the request structure ABI)
+ */
+typedef enum sv_fast_code_t {
+    SVC_FAST_YIELD              = 0x01,
+    /**
+     * r0: msec
+     */
+    SVC_FAST_SLEEP              = 0x02,
+    /**
+     * r0: descriptor, r1: buffer, r2: size
+     */
+    SVC_FAST_WRITE              = 0x03,
+    SVC_FAST_READ               = 0x04,
+    /**
+     * r0: object, r1: word to check (optional), r2: expected value
+     * (thread is suspended only while *r1 == r2)
+     */
+    SVC_FAST_WAIT               = 0x05,
+    SVC_FAST_SIGNAL             = 0x06,
+    /**
+     * result: DWT cycle counter
+     */
+    SVC_FAST_CYCLES             = 0x07,
+} sv_fast_code;
+
+/**
+ * size of fast call table (plain literal: used by the assembly entry)
+ */
+#define SVC_FAST_COUNT 8
+
+/**
+ * @brief      performs fast SV Call (up to three arguments)
+ *
+ * @return     handler result
+ */
+#define sv_fast_call(code, arg0, arg1, arg2) __extension__ ({                 \
+    register uint32_t _sv_r0 asm ("r0") = (uint32_t) (arg0);                 \
+    register uint32_t _sv_r1 asm ("r1") = (uint32_t) (arg1);                 \
+    register uint32_t _sv_r2 asm ("r2") = (uint32_t) (arg2);                 \
+    asm volatile (                                                           \
+        "svc %[imm]                          \n\t"                           \
+        : "+r" (_sv_r0)                                                      \
+        : [imm] "i" (code), "r" (_sv_r1), "r" (_sv_r2)                       \
+        : "memory"                                                           \
+    );                                                                       \
+    (int) _sv_r0;                                                            \
+})
+
 typedef struct memory_request_t {
     /**
      * desired memory size
@@ -154,6 +239,10 @@ typedef struct pipe_recv_request_t {
     const void            *pipe;
 } pipe_recv_request;
 
+/**
+ * NOTE: also used by buffer loan requests (data is output for
+ * reserve/peek, data_size is region size)
+ */
 typedef struct rw_request_t {
     int                    result;
     /**
@@ -170,6 +259,74 @@ typedef struct rw_request_t {
     uint32_t               data_size;
 } rw_request;
 
+/**
+ * submission queue entry
+ */
+typedef struct sv_sqe_t {
+    /**
+     * supervisor call code (sv_code)
+     */
+    uint8_t                code;
+    /**
+     * request structure, completed in place
+     */
+    void                  *req;
+} sv_sqe;
+
+/**
+ * submission queue shared between thread and kernel
+ *
+ * Thread queues entries advancing `head`, kernel executes them in order
+ * and advances `tail` once for the whole batch: entries between old and
+ * new `tail` are completed and their request structures hold results.
+ */
+typedef struct sv_queue_t {
+    sv_sqe                *entries;
+    /**
+     * number of entries minus one (size is a power of two)
+     */
+    uint32_t               mask;
+    volatile uint32_t      head;
+    volatile uint32_t      tail;
+} sv_queue;
+
+typedef struct submit_request_t {
+    /**
+     * number of executed entries
+     */
+    int                    result;
+    sv_queue              *queue;
+} submit_request;
+
+typedef struct timer_request_t {
+    int                    result;
+    ted_timer             *timer;
+    /**
+     * delay before first expiration in mseconds
+     */
+    uint32_t               msecs;
+    /**
+     * re-arm period in mseconds (0 - one shot)
+     */
+    uint32_t               period;
+} timer_request;
+
+typedef struct rwv_request_t {
+    int                    result;
+    /**
+     * descriptor
+     */
+    const void            *dest;
+    /**
+     * segments to write/read to
+     */
+    const io_vec          *vec;
+    /**
+     * number of segments (IO_VEC_MAX at most)
+     */
+    uint32_t               count;
+} rwv_request;
+
 typedef struct socket_peer_request_t {
     const void            *peer;
     const void            *sock;
@@ -186,6 +343,10 @@ typedef struct socket_open_request_t {
      * socket port
      */
     uint8_t                port;
+    /**
+     * connection framing
+     */
+    uint8_t                mode;
 } socket_open_request;
 
 typedef struct socket_connect_request_t {
@@ -232,6 +393,44 @@ typedef struct socket_reply_request_t {
  */
 void sv_call_handler(uint32_t  svc_code, void *svc_arg);
 
+#ifdef SVC_PROFILE
+
+/**
+ * per supervisor call statistics (cycles from DWT counter)
+ */
+typedef struct svc_profile_t {
+    uint32_t               calls;
+    /**
+     * total cycles, 32 bits wrap within a minute of busy calls
+     */
+    uint64_t               cycles;
+    uint32_t               max;
+} svc_profile;
+
+/**
+ * @brief      get supervisor call statistics
+ *
+ * @param[in]  fast     fast call flag (code is sv_fast_code, otherwise sv_code)
+ * @param[in]  code     supervisor call code
+ * @param      profile  statistics (output)
+ *
+ * @return     0 in case of success, otherwise negative (no such code)
+ */
+int svc_profile_get(int fast, uint32_t code, svc_profile *profile);
+
+/**
+ * @brief      reset supervisor call statistics
+ */
+void svc_profile_reset(void);
+
+#endif
+
+/**
+ * @brief      SVCall exception entry: dispatches fast calls by SVC
+ *             immediate, immediate 0 goes to sv_call_handler
+ */
+void sv_call_entry(void);
+
 /**
  * @brief      performs SV Call with given parameter
  *
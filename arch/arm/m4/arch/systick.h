@@ -3,9 +3,41 @@
 
 #include "arch/core.h"
 
+/**
+ * kernel time page: written by SysTick handler only, readable from any
+ * context without a trap (`seq` is odd while update is in progress)
+ */
+typedef struct systick_time_t {
+    volatile uint32_t     seq;
+    volatile int32_t      msec;
+    /**
+     * SysTick reload value (counter ticks per millisecond minus one)
+     */
+    volatile uint32_t     reload;
+} systick_time;
+
+extern systick_time systick_page;
+
+/**
+ * @brief      get milliseconds and microseconds within the millisecond
+ *
+ * Sub-millisecond part comes from SysTick current value which is only
+ * readable in privileged mode, unprivileged callers get 0 there.
+ *
+ * @param      usec  microseconds within the millisecond (output)
+ *
+ * @return     milliseconds since boot
+ */
+int32_t systick_time_get(uint32_t *usec);
+
 /**
  * @brief      initialize systick
  */
 void systick_init(int clock_freq);
 
+/**
+ * @brief      start DWT cycle counter (used for profiling)
+ */
+void cycle_counter_init(void);
+
 #endif
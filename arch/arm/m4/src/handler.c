@@ -2,17 +2,17 @@
 #include "arch/core.h"
 #include "arch/svc.h"
 #include "arch/context.h"
+#include "arch/systick.h"
 
 #include "platform/usart.h"
 
 #include "kernel/ted.h"
 
 #include "lib/string.h"
+#include "common/log.h"
 
 #include "kernel/thread.h"
 
-volatile int32_t     systick_msec = 0;
-
 extern void sv_schedule_routine(void*);
 
 extern core_context  *core_context_cur;
@@ -22,6 +22,9 @@ extern int context_switch_scheduled;
 
 __attribute__((used))
 static void print_fault(uint32_t * stack, uint32_t exc) {
+    log_drain();
+    flush();
+
     printf("CPU Hard Fault.\n");
     printf("EXC_RETURN     : 0x%08x\n", exc);
     printf("SCB->HFSR      : 0x%08x\n", HFSR);
@@ -70,14 +73,46 @@ static void print_fault(uint32_t * stack, uint32_t exc) {
         node = node->nxt;
     }
 
+    //! interrupts are blocked from now on: push queued output out by hand
+    flush();
+
     asm volatile("bkpt #00\n\t");
     while (1);
 }
 
+isr_stat isr_stats[ISR_ID_MAX];
+
+int isr_stat_get(isr_id id, isr_stat *stat) {
+    if (id >= ISR_ID_MAX || !stat) {
+        return -1;
+    }
+
+    *stat = isr_stats[id];
+
+    return 0;
+}
+
+void isr_stat_reset(void) {
+    memset(isr_stats, 0, sizeof(isr_stats));
+}
+
 void systick_handler(void) {
+    uint32_t start = isr_enter();
+
     sv_schedule_routine(NULL);
 
-    systick_msec++;
+    //! seqlock: readers retry while seq is odd or changed
+    systick_page.seq++;
+    __sync_synchronize();
+
+    systick_page.msec++;
+
+    __sync_synchronize();
+    systick_page.seq++;
+
+    ted_tick(systick_page.msec);
+
+    isr_exit(ISR_SYSTICK, start);
 }
 
 void pend_sv_handler(void) {
@@ -121,6 +156,7 @@ void pend_sv_handler(void) {
 
 void default_handler(void) {
     printf("unhandled interrupt!!!");
+    flush();
     while (1);
 }
 
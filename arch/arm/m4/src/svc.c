@@ -144,6 +144,28 @@ void sv_pipe_recv(void *arg) {
     req->pipe = pipe_get_ready(thread_get(NULL));
 }
 
+static
+int sv_do_write(const void *dest, char *data, uint32_t data_size) {
+    if (is_pipe(dest)) {
+        return pipe_write(dest, thread_get(NULL), data, data_size);
+    } else if (is_sock(dest) || is_sock_conn(dest)) {
+        return socket_write(dest, thread_get(NULL), data, data_size);
+    }
+
+    return -7;
+}
+
+static
+int sv_do_read(const void *dest, char *data, uint32_t data_size) {
+    if (is_pipe(dest)) {
+        return pipe_read(dest, thread_get(NULL), data, data_size);
+    } else if (is_sock_conn(dest)) {
+        return socket_read(dest, thread_get(NULL), data, data_size);
+    }
+
+    return -7;
+}
+
 static
 void sv_write(void *arg) {
     rw_request *req = (rw_request*) arg;
@@ -151,26 +173,107 @@ void sv_write(void *arg) {
         return;
     }
 
-    if (is_pipe(req->dest)) {
-        req->result = pipe_write(req->dest, thread_get(NULL), req->data, req->data_size);
-    } else if (is_sock(req->dest) || is_sock_conn(req->dest)) {
-        req->result = socket_write(req->dest, thread_get(NULL), req->data, req->data_size);
+    req->result = sv_do_write(req->dest, req->data, req->data_size);
+}
+
+static
+void sv_read(void *arg) {
+    rw_request *req = (rw_request*) arg;
+    if (!req) {
+        return;
+    }
+
+    req->result = sv_do_read(req->dest, req->data, req->data_size);
+}
+
+static
+void sv_writev(void *arg) {
+    rwv_request *req = (rwv_request*) arg;
+    if (!req) {
+        return;
+    }
+
+    if (!req->vec || !req->count || req->count > IO_VEC_MAX) {
+        req->result = -8;
+    } else if (is_pipe(req->dest)) {
+        req->result = pipe_writev(req->dest, thread_get(NULL), req->vec, req->count);
+    } else if (is_sock_conn(req->dest)) {
+        req->result = socket_writev(req->dest, thread_get(NULL), req->vec, req->count);
     } else {
         req->result = -7;
     }
 }
 
 static
-void sv_read(void *arg) {
-    rw_request *req = (rw_request*) arg;
+void sv_readv(void *arg) {
+    rwv_request *req = (rwv_request*) arg;
     if (!req) {
         return;
     }
 
-    if (is_pipe(req->dest)) {
-        req->result = pipe_read(req->dest, thread_get(NULL), req->data, req->data_size);
+    if (!req->vec || !req->count || req->count > IO_VEC_MAX) {
+        req->result = -8;
+    } else if (is_pipe(req->dest)) {
+        req->result = pipe_readv(req->dest, thread_get(NULL), req->vec, req->count);
     } else if (is_sock_conn(req->dest)) {
-        req->result = socket_read(req->dest, thread_get(NULL), req->data, req->data_size);
+        req->result = socket_readv(req->dest, thread_get(NULL), req->vec, req->count);
+    } else {
+        req->result = -7;
+    }
+}
+
+static
+void sv_write_reserve(void *arg) {
+    rw_request *req = (rw_request*) arg;
+    if (!req) {
+        return;
+    }
+
+    if (is_sock_conn(req->dest)) {
+        req->result = socket_write_reserve(req->dest, thread_get(NULL), req->data_size,
+            (void **) &req->data);
+    } else {
+        req->result = -7;
+    }
+}
+
+static
+void sv_write_commit(void *arg) {
+    rw_request *req = (rw_request*) arg;
+    if (!req) {
+        return;
+    }
+
+    if (is_sock_conn(req->dest)) {
+        req->result = socket_write_commit(req->dest, thread_get(NULL), req->data_size);
+    } else {
+        req->result = -7;
+    }
+}
+
+static
+void sv_read_peek(void *arg) {
+    rw_request *req = (rw_request*) arg;
+    if (!req) {
+        return;
+    }
+
+    if (is_sock_conn(req->dest)) {
+        req->result = socket_read_peek(req->dest, thread_get(NULL), (const void **) &req->data);
+    } else {
+        req->result = -7;
+    }
+}
+
+static
+void sv_read_release(void *arg) {
+    rw_request *req = (rw_request*) arg;
+    if (!req) {
+        return;
+    }
+
+    if (is_sock_conn(req->dest)) {
+        req->result = socket_read_release(req->dest, thread_get(NULL), req->data_size);
     } else {
         req->result = -7;
     }
@@ -213,7 +316,7 @@ void sv_sock_open(void *arg) {
         return;
     }
 
-    req->result = socket_create(thread_get(NULL), req->port);
+    req->result = socket_create(thread_get(NULL), req->port, req->mode);
 }
 
 static
@@ -275,6 +378,29 @@ void sv_signal(void *arg) {
     }
 }
 
+static
+void sv_timer_start(void *arg) {
+    timer_request *req = (timer_request*) arg;
+    if (!req) {
+        return;
+    }
+
+    req->result = ted_timer_start(req->timer, req->msecs, req->period);
+}
+
+static
+void sv_timer_cancel(void *arg) {
+    timer_request *req = (timer_request*) arg;
+    if (!req) {
+        return;
+    }
+
+    req->result = ted_timer_cancel(req->timer);
+}
+
+static
+void sv_submit(void *arg);
+
 void (*svc_handlers[])(void*) = {
     sv_user_mode,
     sv_memory,
@@ -295,11 +421,263 @@ void (*svc_handlers[])(void*) = {
     sv_sock_select,
     sv_wait,
     sv_signal,
+    sv_write_reserve,
+    sv_write_commit,
+    sv_read_peek,
+    sv_read_release,
+    sv_writev,
+    sv_readv,
+    sv_submit,
+    sv_timer_start,
+    sv_timer_cancel,
 };
 
+/**
+ * @brief      execute queued requests
+ *
+ * NOTE: entries which block or reschedule (wait, sleep) take effect once
+ *       the whole batch is executed
+ */
+static
+void sv_submit(void *arg) {
+    submit_request *req = (submit_request*) arg;
+    if (!req) {
+        return;
+    }
+
+    sv_queue *queue = req->queue;
+    if (!queue || !queue->entries) {
+        req->result = -8;
+        return;
+    }
+
+    int executed = 0;
+
+    uint32_t tail = queue->tail;
+    while (tail != queue->head) {
+        sv_sqe *sqe = &queue->entries[tail & queue->mask];
+
+        //! malformed entries are consumed, their requests left untouched
+        if (sqe->code != SVC_USER_MODE && sqe->code != SVC_SUBMIT &&
+            sqe->code < countof(svc_handlers)) {
+            svc_handlers[sqe->code](sqe->req);
+
+            executed++;
+        }
+
+        tail++;
+    }
+
+    //! single completion update for the whole batch
+    queue->tail = tail;
+
+    req->result = executed;
+}
+
+/**
+ * fast call handlers get caller's stacked r0-r3, result goes to r0
+ */
+typedef int (*sv_fast_handler)(const uint32_t *args);
+
+static
+int sv_fast_yield(const uint32_t *args) {
+    (void) args;
+
+    thread_yield();
+    sv_schedule_routine(NULL);
+
+    return 0;
+}
+
+static
+int sv_fast_sleep(const uint32_t *args) {
+    thread_delay((int32_t) args[0]);
+    sv_schedule_routine(NULL);
+
+    return 0;
+}
+
+static
+int sv_fast_write(const uint32_t *args) {
+    return sv_do_write((const void *) args[0], (char *) args[1], args[2]);
+}
+
+static
+int sv_fast_read(const uint32_t *args) {
+    return sv_do_read((const void *) args[0], (char *) args[1], args[2]);
+}
+
+static
+int sv_fast_wait(const uint32_t *args) {
+    const volatile uint32_t *word = (const volatile uint32_t *) args[1];
+
+    //! condition changed before the call: signal is already sent
+    if (word && *word != args[2]) {
+        return 0;
+    }
+
+    thread_suspend(thread_get(NULL), (const void *) args[0]);
+    sv_schedule_routine(NULL);
+
+    return 0;
+}
+
+static
+int sv_fast_signal(const uint32_t *args) {
+    if (args[0]) {
+        thread_signal((const void *) args[0]);
+        sv_schedule_routine(NULL);
+    }
+
+    return 0;
+}
+
+static
+int sv_fast_cycles(const uint32_t *args) {
+    (void) args;
+
+    return DWT_CYCCNT;
+}
+
+__attribute__((used))
+static
+const sv_fast_handler svc_fast_handlers[SVC_FAST_COUNT] = {
+    [SVC_FAST_YIELD]  = sv_fast_yield,
+    [SVC_FAST_SLEEP]  = sv_fast_sleep,
+    [SVC_FAST_WRITE]  = sv_fast_write,
+    [SVC_FAST_READ]   = sv_fast_read,
+    [SVC_FAST_WAIT]   = sv_fast_wait,
+    [SVC_FAST_SIGNAL] = sv_fast_signal,
+    [SVC_FAST_CYCLES] = sv_fast_cycles,
+};
+
+#define SV_STR(x)  #x
+#define SV_XSTR(x) SV_STR(x)
+
+#ifdef SVC_PROFILE
+
+static svc_profile svc_profile_table[countof(svc_handlers)];
+
+static svc_profile svc_profile_fast_table[SVC_FAST_COUNT];
+
+static inline
+void sv_profile_account(svc_profile *entry, uint32_t start) {
+    uint32_t elapsed = DWT_CYCCNT - start;
+
+    entry->calls++;
+    entry->cycles += elapsed;
+
+    if (elapsed > entry->max) {
+        entry->max = elapsed;
+    }
+}
+
+/**
+ * @brief      profiled fast call dispatch (r0 - stacked frame, r1 - code)
+ */
+__attribute__((used))
+static
+int sv_fast_profile(const uint32_t *args, uint32_t code) {
+    if (!svc_fast_handlers[code]) {
+        return args[0];
+    }
+
+    uint32_t start = DWT_CYCCNT;
+
+    int ret = svc_fast_handlers[code](args);
+
+    sv_profile_account(&svc_profile_fast_table[code], start);
+
+    return ret;
+}
+
+int svc_profile_get(int fast, uint32_t code, svc_profile *profile) {
+    if (!profile) {
+        return -1;
+    }
+
+    if (fast) {
+        if (code >= SVC_FAST_COUNT) {
+            return -1;
+        }
+
+        *profile = svc_profile_fast_table[code];
+    } else {
+        if (code >= countof(svc_profile_table)) {
+            return -1;
+        }
+
+        *profile = svc_profile_table[code];
+    }
+
+    return 0;
+}
+
+void svc_profile_reset(void) {
+    memset(svc_profile_table, 0, sizeof(svc_profile_table));
+    memset(svc_profile_fast_table, 0, sizeof(svc_profile_fast_table));
+}
+
+//! fast call (r12 - code, r4 - stacked frame) through the profiling wrapper
+#define SV_FAST_DISPATCH                                                     \
+        "mov    r1, r12                      \n\t"                           \
+        "mov    r0, r4                       \n\t"                           \
+        "bl     sv_fast_profile              \n\t"
+
+#else
+
+//! fast call (r12 - code, r4 - stacked frame) straight from the table
+#define SV_FAST_DISPATCH                                                     \
+        "movw   lr, #:lower16:svc_fast_handlers \n\t"                        \
+        "movt   lr, #:upper16:svc_fast_handlers \n\t"                        \
+        "ldr    r12, [lr, r12, lsl #2]       \n\t"                           \
+        "cmp    r12, #0                      \n\t"                           \
+        "beq    sv_entry_exit                \n\t"                           \
+        "mov    r0, r4                       \n\t"                           \
+        "blx    r12                          \n\t"
+
+#endif
+
+__attribute__((naked))
+void sv_call_entry(void) {
+    asm volatile(
+        "push   {r4, lr}                     \n\t"
+        //! locate stacked frame: MSP (below pushed pair) or PSP
+        "tst    lr, #4                       \n\t"
+        "ite    eq                           \n\t"
+        "addeq  r4, sp, #8                   \n\t"
+        "mrsne  r4, psp                      \n\t"
+        //! SVC immediate: low byte of the instruction before stacked pc
+        "ldr    r12, [r4, #24]               \n\t"
+        "ldrb   r12, [r12, #-2]              \n\t"
+        "cmp    r12, #0                      \n\t"
+        "beq    sv_entry_legacy              \n\t"
+        "cmp    r12, #" SV_XSTR(SVC_FAST_COUNT) "\n\t"
+        "bhs    sv_entry_exit                \n\t"
+        SV_FAST_DISPATCH
+        //! result is returned through stacked r0
+        "str    r0, [r4]                     \n\t"
+        "sv_entry_exit:                      \n\t"
+        "pop    {r4, pc}                     \n\t"
+        //! request structure ABI: r0 - code, r1 - request
+        "sv_entry_legacy:                    \n\t"
+        "ldm    r4, {r0, r1}                 \n\t"
+        "bl     sv_call_handler              \n\t"
+        "pop    {r4, pc}                     \n\t"
+    );
+}
+
 void sv_call_handler(uint32_t svc_code, void *svc_arg) {
     if (svc_code < countof(svc_handlers)) {
+#ifdef SVC_PROFILE
+        uint32_t start = DWT_CYCCNT;
+
+        svc_handlers[svc_code](svc_arg);
+
+        sv_profile_account(&svc_profile_table[svc_code], start);
+#else
         svc_handlers[svc_code](svc_arg);
+#endif
     }
 }
 
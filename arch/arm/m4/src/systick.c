@@ -1,5 +1,43 @@
 #include "arch/systick.h"
 
+systick_time systick_page = {0};
+
+int32_t systick_time_get(uint32_t *usec) {
+    int privileged = core_privileged();
+
+    uint32_t seq;
+    int32_t  msec;
+    uint32_t ticks;
+
+    do {
+        seq = systick_page.seq;
+
+        __sync_synchronize();
+
+        msec  = systick_page.msec;
+        ticks = 0;
+
+        if (privileged) {
+            //! counts down from reload
+            ticks = systick_page.reload - STK_CVR;
+
+            //! counter wrapped but tick is not handled yet
+            if (ICSR & BIT26) {
+                msec++;
+                ticks = 0;
+            }
+        }
+
+        __sync_synchronize();
+    } while ((seq & 1) || seq != systick_page.seq);
+
+    if (usec) {
+        *usec = systick_page.reload ? ticks * 1000 / (systick_page.reload + 1) : 0;
+    }
+
+    return msec;
+}
+
 void systick_init(int clock_freq) {
     STK_CSR |= ( BIT2 | BIT1 | BIT0);
     //! set systick prescaler
@@ -7,8 +45,19 @@ void systick_init(int clock_freq) {
     STK_RVR = (clock_freq / 1000);
     STK_CVR = 0;
 
+    systick_page.reload = STK_RVR;
+
     //! high priority for systick exception
     SHPR3 |= (0x0f << 24);
     //! the lowest possible priority for PendSV exception
     SHPR3 |= (0xff << 16);
 }
+
+void cycle_counter_init(void) {
+    //! TRCENA: enable DWT
+    DEMCR |= BIT24;
+
+    DWT_CYCCNT = 0;
+    //! CYCCNTENA
+    DWT_CTRL |= BIT0;
+}
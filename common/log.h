@@ -3,13 +3,105 @@
 
 #include "lib/string.h"
 
-#define LOG_INF(fmt, ...)   printf("[INFO]  %s::%s():%d " fmt "\n", \
-                            __FILE__, __func__, __LINE__, ##__VA_ARGS__)
-#define LOG_DBG(fmt, ...)   printf("[DEBUG] %s::%s():%d " fmt "\n", \
-                            __FILE__, __func__, __LINE__, ##__VA_ARGS__)
-#define LOG_ERR(fmt, ...)   printf("[ERROR] %s::%s():%d " fmt "\n", \
-                            __FILE__, __func__, __LINE__, ##__VA_ARGS__)
-#define LOG_TRACE()         printf("[TRACE] %s::%s():%d\n", __FILE__, \
-                            __func__, __LINE__)
+/**
+ * log levels, messages above LOG_LEVEL are compiled out
+ */
+#define LOG_LEVEL_NONE      0
+#define LOG_LEVEL_ERR       1
+#define LOG_LEVEL_INF       2
+#define LOG_LEVEL_DBG       3
+#define LOG_LEVEL_TRACE     4
+
+#ifndef LOG_LEVEL
+#define LOG_LEVEL           LOG_LEVEL_TRACE
+#endif
+
+/**
+ * max number of message arguments (32 bit words)
+ */
+#define LOG_ARGS_MAX        4
+
+/**
+ * call site description, lives in flash: only a pointer to it and raw
+ * arguments are queued by the caller
+ */
+typedef struct log_site_t {
+    const char            *fmt;
+    const char            *file;
+    const char            *func;
+    uint16_t               line;
+    uint8_t                level;
+    uint8_t                nargs;
+} log_site;
+
+/**
+ * @brief      queue message for log thread (any context, lock-free)
+ *
+ * NOTE: arguments are formatted later, `%s` arguments MUST point to
+ *       static storage
+ *
+ * @param[in]  site  call site
+ * @param[in]  args  site->nargs raw arguments
+ */
+void log_post(const log_site *site, const uint32_t *args);
+
+/**
+ * @brief      format and emit all queued messages in caller context
+ */
+void log_drain(void);
+
+/**
+ * @brief      get number of messages dropped on full queue
+ */
+uint32_t log_dropped(void);
+
+#define LOG_NARGS(...)      LOG_NARGS_(0, ##__VA_ARGS__, 8, 7, 6, 5, 4, 3, 2, 1, 0)
+#define LOG_NARGS_(_0, _1, _2, _3, _4, _5, _6, _7, _8, _n, ...) _n
+
+#define LOG_POST(_level, _fmt, ...) do {                                     \
+    _Static_assert(LOG_NARGS(__VA_ARGS__) <= LOG_ARGS_MAX,                   \
+        "too many log arguments");                                           \
+    static const log_site _log_site = {                                      \
+        .fmt   = _fmt,                                                       \
+        .file  = __FILE__,                                                   \
+        .func  = __func__,                                                   \
+        .line  = __LINE__,                                                   \
+        .level = _level,                                                     \
+        .nargs = LOG_NARGS(__VA_ARGS__),                                     \
+    };                                                                       \
+    const uint32_t _log_args[LOG_ARGS_MAX + 1] = { 0, ##__VA_ARGS__ };       \
+    log_post(&_log_site, &_log_args[1]);                                     \
+} while (0)
+
+//! keep arguments type checked and used when level is compiled out
+#define LOG_SKIP(fmt, ...)  do {                                             \
+    if (0) {                                                                 \
+        printf(fmt, ##__VA_ARGS__);                                          \
+    }                                                                        \
+} while (0)
+
+#if LOG_LEVEL >= LOG_LEVEL_ERR
+#define LOG_ERR(fmt, ...)   LOG_POST(LOG_LEVEL_ERR, fmt, ##__VA_ARGS__)
+#else
+#define LOG_ERR(fmt, ...)   LOG_SKIP(fmt, ##__VA_ARGS__)
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_INF
+#define LOG_INF(fmt, ...)   LOG_POST(LOG_LEVEL_INF, fmt, ##__VA_ARGS__)
+#else
+#define LOG_INF(fmt, ...)   LOG_SKIP(fmt, ##__VA_ARGS__)
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_DBG
+#define LOG_DBG(fmt, ...)   LOG_POST(LOG_LEVEL_DBG, fmt, ##__VA_ARGS__)
+#else
+#define LOG_DBG(fmt, ...)   LOG_SKIP(fmt, ##__VA_ARGS__)
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_TRACE
+#define LOG_TRACE()         LOG_POST(LOG_LEVEL_TRACE, "")
+#else
+#define LOG_TRACE()         do {} while (0)
+#endif
 
 #endif
@@ -0,0 +1,150 @@
+#include "common/log.h"
+#include "kernel/thread.h"
+#include "kernel/syscall.h"
+#include "platform/clock.h"
+
+/**
+ * max number of queued messages (power of two)
+ */
+#define LOG_QUEUE_SIZE      32
+#define LOG_QUEUE_MASK      (LOG_QUEUE_SIZE - 1)
+
+//! log thread wakeup period in mseconds
+#define LOG_PERIOD          20
+
+/**
+ * queued message, `site` is written last and marks entry as complete
+ */
+typedef struct log_entry_t {
+    const log_site * volatile site;
+    int32_t                   time;
+    uint32_t                  args[LOG_ARGS_MAX];
+} log_entry;
+
+static
+log_entry         log_queue[LOG_QUEUE_SIZE];
+
+//! reserved by producers (compare-and-swap, any context)
+static
+volatile uint32_t log_head     = 0;
+
+//! advanced by consumer only
+static
+volatile uint32_t log_tail     = 0;
+
+static
+volatile uint32_t log_lost     = 0;
+
+static
+uint32_t          log_reported = 0;
+
+static
+const char *const log_tags[] = {
+    [LOG_LEVEL_NONE]  = "",
+    [LOG_LEVEL_ERR]   = "[ERROR]",
+    [LOG_LEVEL_INF]   = "[INFO] ",
+    [LOG_LEVEL_DBG]   = "[DEBUG]",
+    [LOG_LEVEL_TRACE] = "[TRACE]",
+};
+
+void log_post(const log_site *site, const uint32_t *args) {
+    uint32_t head;
+
+    do {
+        head = log_head;
+
+        if (head - log_tail > LOG_QUEUE_MASK) {
+            __sync_fetch_and_add(&log_lost, 1);
+            return;
+        }
+    } while (!__sync_bool_compare_and_swap(&log_head, head, head + 1));
+
+    log_entry *entry = &log_queue[head & LOG_QUEUE_MASK];
+
+    entry->time = clock_get();
+    memcpy(entry->args, args, site->nargs * sizeof(uint32_t));
+
+    __sync_synchronize();
+
+    entry->site = site;
+}
+
+uint32_t log_dropped(void) {
+    return log_lost;
+}
+
+#ifdef LOG_BINARY
+/**
+ * @brief      emit raw record, decoded on host (scripts/log_decode.py)
+ *
+ * Line format: '#' site time args... (32 bit hex words). Stdio is a text
+ * channel ('\n' is expanded), so words are sent hex encoded.
+ */
+static
+void log_emit(const log_entry *entry, const log_site *site) {
+    printf("#%08x%08x", (uint32_t) site, entry->time);
+
+    for (uint32_t i = 0; i < site->nargs; i++) {
+        printf("%08x", entry->args[i]);
+    }
+
+    printf("\n");
+}
+#else
+static
+void log_emit(const log_entry *entry, const log_site *site) {
+    const uint32_t *args = entry->args;
+
+    printf("%s %s::%s():%d", log_tags[site->level], site->file, site->func,
+        site->line);
+
+    if (*site->fmt) {
+        printf(" ");
+        //! unused trailing words are ignored by the formatter
+        printf(site->fmt, args[0], args[1], args[2], args[3]);
+    }
+
+    printf("\n");
+}
+#endif
+
+void log_drain(void) {
+    while (log_tail != log_head) {
+        log_entry *entry = &log_queue[log_tail & LOG_QUEUE_MASK];
+
+        //! reserved, but producer has not finished yet
+        const log_site *site = entry->site;
+        if (!site) {
+            break;
+        }
+
+        __sync_synchronize();
+
+        log_emit(entry, site);
+
+        entry->site = NULL;
+
+        __sync_synchronize();
+
+        log_tail++;
+    }
+
+    uint32_t lost = log_lost;
+    if (lost != log_reported) {
+        printf("%s log: %d messages dropped\n", log_tags[LOG_LEVEL_ERR],
+            lost - log_reported);
+
+        log_reported = lost;
+    }
+}
+
+static
+void log_loop(void) {
+    while (1) {
+        log_drain();
+
+        sleep(LOG_PERIOD);
+    }
+}
+
+KERNEL_SRV(log, log_loop, 256, 1);
@@ -0,0 +1,154 @@
+#ifndef DRIVER_BCACHE_H
+#define DRIVER_BCACHE_H
+
+#include "common/common.h"
+#include "driver/disk.h"
+
+/**
+ * block cache on top of disk interface
+ *
+ * Cache holds fixed number of slots, each slot keeps `block_size` bytes
+ * read from consecutive disk blocks, starting at the block slot is keyed
+ * by. Slot is replaced using CLOCK, pinned slots are never replaced.
+ * Blocks loaded ahead of use go to separate read-ahead slots, so
+ * read-ahead never pushes out blocks that are in use.
+ */
+typedef struct bcache_t bcache;
+
+typedef struct bcache_stat_t {
+    uint32_t hits;
+    uint32_t misses;
+    uint32_t evictions;
+    /**
+     * disk blocks read by the cache
+     */
+    uint32_t disk_reads;
+    /**
+     * cache blocks loaded ahead of use by bcache_prefetch
+     */
+    uint32_t prefetched;
+    /**
+     * prefetched blocks replaced before they were used
+     */
+    uint32_t prefetch_wasted;
+} bcache_stat;
+
+/**
+ * @brief      create block cache
+ *
+ * @param      disk         backing disk
+ * @param[in]  block_size   cache block size (multiple of disk block size)
+ * @param[in]  slot_count   number of cache slots
+ * @param[in]  ahead_count  number of read-ahead slots (0 - no read-ahead)
+ *
+ * NOTE: data of all slots is one heap cell, so block size times slot
+ *       count (read-ahead slots included) is limited to 64 KiB
+ *
+ * @return     block cache, NULL on failure
+ */
+bcache *bcache_create(disk_ifc *disk, uint32_t block_size, uint32_t slot_count,
+    uint32_t ahead_count);
+
+/**
+ * @brief      destroy block cache (backing disk is kept)
+ *
+ * @param      cache  block cache
+ */
+void bcache_destroy(bcache *cache);
+
+/**
+ * @brief      change cache block size, cached data is dropped
+ *
+ * @param      cache       block cache
+ * @param[in]  block_size  new block size (multiple of disk block size)
+ *
+ * @return     0 on success, fails if any slot is pinned or slots of the
+ *             new size don't fit 64 KiB (cache is left as it was)
+ */
+int bcache_block_size_set(bcache *cache, uint32_t block_size);
+
+/**
+ * @brief      get cache block size
+ */
+uint32_t bcache_block_size(bcache *cache);
+
+/**
+ * @brief      get backing disk block size
+ */
+uint32_t bcache_disk_block_size(bcache *cache);
+
+/**
+ * @brief      get block data, slot is pinned until bcache_put
+ *
+ * @param      cache  block cache
+ * @param[in]  blk    first disk block
+ *
+ * @return     block data, NULL on read error or if every slot is pinned
+ */
+const uint8_t *bcache_get(bcache *cache, uint32_t blk);
+
+/**
+ * @brief      unpin block
+ *
+ * @param      cache  block cache
+ * @param[in]  data   any pointer into data returned by bcache_get
+ */
+void bcache_put(bcache *cache, const void *data);
+
+/**
+ * @brief      read consecutive cache blocks into buffer
+ *
+ * Cached blocks are copied, each run of uncached blocks is transferred
+ * with a single ranged disk read and isn't kept in the cache.
+ *
+ * @param      cache  block cache
+ * @param[in]  blk    first disk block
+ * @param[in]  count  number of cache blocks
+ * @param      buf    destination (count * block size bytes)
+ *
+ * @return     0 on success
+ */
+int bcache_read(bcache *cache, uint32_t blk, uint32_t count, uint8_t *buf);
+
+/**
+ * @brief      load consecutive cache blocks ahead of use
+ *
+ * Blocks that aren't cached yet are read into read-ahead slots, oldest
+ * read-ahead slot is reused first. Each run goes straight into adjacent
+ * slots with a single ranged read, it is split only where read-ahead
+ * slots wrap around or one of them is pinned. At most `ahead_count`
+ * blocks are loaded, fewer if some read-ahead slots are pinned.
+ *
+ * @param      cache  block cache
+ * @param[in]  blk    first disk block
+ * @param[in]  count  number of cache blocks
+ *
+ * @return     number of blocks loaded, negative on read error
+ */
+int bcache_prefetch(bcache *cache, uint32_t blk, uint32_t count);
+
+/**
+ * @brief      drop all unpinned blocks
+ *
+ * @param      cache  block cache
+ */
+void bcache_invalidate(bcache *cache);
+
+/**
+ * @brief      get cache counters
+ *
+ * @param      cache  block cache
+ * @param      stat   counters
+ *
+ * @return     0 on success
+ */
+int bcache_stat_get(bcache *cache, bcache_stat *stat);
+
+/**
+ * @brief      clear cache counters
+ *
+ * @param      cache  block cache
+ */
+void bcache_stat_reset(bcache *cache);
+
+#endif
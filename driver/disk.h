@@ -6,13 +6,19 @@
 typedef struct disk_stat_t {
     uint32_t size_mb;
     uint32_t block_size;
+    uint32_t blocks;
 } disk_stat;
 
 typedef struct disk_ifc_t {
     int (*read)(struct disk_ifc_t *iface, uint32_t blk, uint8_t *buf);
     int (*write)(struct disk_ifc_t *iface, uint32_t blk, const uint8_t *buf);
+    /**
+     * transfer `count` consecutive blocks starting at `blk` as one request
+     */
+    int (*read_blocks)(struct disk_ifc_t *iface, uint32_t blk, uint32_t count, uint8_t *buf);
+    int (*write_blocks)(struct disk_ifc_t *iface, uint32_t blk, uint32_t count, const uint8_t *buf);
     int (*get_stat)(struct disk_ifc_t *iface, disk_stat *stat);
     void  (*destroy)(struct disk_ifc_t *iface);
 } disk_ifc;
 
-#endif
\ No newline at end of file
+#endif
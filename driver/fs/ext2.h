@@ -3,8 +3,18 @@
 
 #include "common/common.h"
 #include "fs/fs.h"
-#include "driver/disk.h"
+#include "driver/bcache.h"
 
-fs_ifc *ext2_init(disk_ifc *disk, uint32_t disk_blk);
+/**
+ * @brief      initialize ext2 filesystem
+ *
+ * Cache block size is switched to filesystem block size.
+ *
+ * @param      cache     block cache of the disk
+ * @param[in]  disk_blk  first disk block of the partition
+ *
+ * @return     filesystem interface, NULL on failure
+ */
+fs_ifc *ext2_init(bcache *cache, uint32_t disk_blk);
 
 #endif
@@ -32,6 +32,16 @@ typedef struct fs_ifc_t {
     file_desc* (*mount)(struct fs_ifc_t *ifc, const char *root_path);
     int (*read)(struct fs_ifc_t *ifc, file_desc *fd, uint8_t *buf, uint32_t buf_size, uint32_t offset);
     int (*write)(struct fs_ifc_t *ifc, file_desc *fd, uint8_t *buf, uint32_t buf_size, uint32_t offset);
+    //! load file range into cache ahead of reading it (optional)
+    int (*prefetch)(struct fs_ifc_t *ifc, file_desc *fd, uint32_t offset, uint32_t size);
+    //! drop state kept for open file (optional)
+    void (*release)(struct fs_ifc_t *ifc, file_desc *fd);
+    //! load directory entries on first access (optional, loaded by mount otherwise)
+    int (*load)(struct fs_ifc_t *ifc, file_desc *dir);
+    //! drop loaded directory entries, subtree included (optional)
+    void (*unload)(struct fs_ifc_t *ifc, file_desc *dir);
+    //! free filesystem context, backing cache is kept
+    void (*destroy)(struct fs_ifc_t *ifc);
 } fs_ifc;
 
 const char *fs_current_path_get(void);
@@ -1,4 +1,5 @@
 #include "fs/ext2.h"
+#include "common/utils.h"
 #include "kernel/syscall.h"
 #include "lib/string.h"
 
@@ -17,6 +18,12 @@
 #define REV0_INODE_SIZE  128
 #define REV0_INODE_FIRST 11
 
+//! extents remembered per open file
+#define EXT2_MAP_EXTENTS 8
+
+//! decoded inodes kept in memory
+#define EXT2_INODE_CACHE_SIZE 8
+
 #define UUID_P "%02x%02x%02x%02x-%02x%02x%02x%02x-%02x%02x%02x%02x-%02x%02x%02x%02x\n"
 #define UUID(_u) _u[0],  _u[1],  _u[2],  _u[3], \
                  _u[4],  _u[5],  _u[6],  _u[7], \
@@ -161,17 +168,30 @@ typedef struct dir_t {
     char             name[];
 } __attribute__((packed)) dir;
 
+typedef struct ext2_inode_slot_t {
+    //! inode number, 0 - slot is empty
+    uint32_t           idx;
+    //! last use, least recently used slot is replaced
+    uint32_t           stamp;
+    inode              data;
+} ext2_inode_slot;
+
 typedef struct ext2_ctx_t {
     fs_ifc             ifc;
     ext2_superblock    sb;
-    disk_ifc          *disk;
+    bcache            *cache;
     uint32_t           disk_offset;
+    //! disk blocks per filesystem block
+    uint32_t           disk_blocks;
     uint32_t           grp_count;
     uint32_t           block_desc_block;
     uint32_t           block_size;
     uint32_t           inode_size;
     uint32_t           first_inode;
-    uint8_t            block[];
+    //! block group descriptor table, loaded at init (NULL if too large)
+    block_group_desc_table *grp_desc;
+    uint32_t           inode_clock;
+    ext2_inode_slot    inode_cache[EXT2_INODE_CACHE_SIZE];
 } ext2_ctx;
 
 typedef enum dir_entry_type_t {
@@ -186,15 +206,37 @@ typedef enum dir_entry_type_t {
 } dir_entry_type;
 
 typedef struct file_read_opt_t {
-    uint32_t  offset;
-    uint32_t  block_offset;
     uint8_t  *buf;
     uint32_t  buf_size;
-    uint32_t  block_num;
+    //! pending run of physically contiguous whole blocks
+    uint32_t  run_block;
+    uint32_t  run_len;
+    uint8_t  *run_buf;
 } file_read_opt;
 
+/**
+ * file blocks [logical, logical + len) are stored at [block, block + len)
+ */
+typedef struct ext2_extent_t {
+    uint32_t         logical;
+    uint32_t         block;
+    uint32_t         len;
+} ext2_extent;
+
+/**
+ * logical to physical block map of open file, filled as blocks are resolved
+ */
+typedef struct ext2_block_map_t {
+    uint32_t         count;
+    //! extent replaced next once map is full
+    uint32_t         victim;
+    ext2_extent      extent[EXT2_MAP_EXTENTS];
+} ext2_block_map;
+
 typedef struct ext2_desc_priv_data_t {
-    uint32_t inode;
+    uint32_t         inode;
+    //! allocated on first read, dropped on release
+    ext2_block_map  *map;
 } ext2_desc_priv_data;
 
 #if 0
@@ -237,162 +279,458 @@ static void sb_dump(ext2_superblock *sb) {
 }
 #endif
 
-static int disk_read_block(ext2_ctx *ctx, uint32_t block) {
-    disk_stat disk_stat;
-    ctx->disk->get_stat(ctx->disk, &disk_stat);
-
-    uint32_t to_read = ctx->block_size;
-    uint8_t *ptr = ctx->block;
-    uint32_t read_blk = ctx->disk_offset + (block * (ctx->block_size / disk_stat.block_size));
-    while (to_read) {
-        if (ctx->disk->read(ctx->disk, read_blk, ptr)) {
-            return -1;
-        }
-        read_blk++;
-        ptr += disk_stat.block_size;
-        to_read -= disk_stat.block_size;
-    }
+/**
+ * @brief      get filesystem block from cache, release with block_put
+ *
+ * @return     block data, NULL on failure
+ */
+static const uint8_t *block_get(ext2_ctx *ctx, uint32_t block) {
+    return bcache_get(ctx->cache, ctx->disk_offset + block * ctx->disk_blocks);
+}
 
-    return 0;
+static void block_put(ext2_ctx *ctx, const void *data) {
+    bcache_put(ctx->cache, data);
 }
 
-static int read_direct_block(ext2_ctx *ctx, file_read_opt *opt, uint32_t block) {
-    opt->block_num++;
-    if (opt->offset >= (opt->block_num * ctx->block_size)) {
-        //! didn't reach offset yet, NOT an error
+/**
+ * @brief      read pending run of whole blocks with a single ranged read
+ *
+ * @return     0 on success, data of the run is dropped from result on failure
+ */
+static int flush_run(ext2_ctx *ctx, file_read_opt *opt) {
+    if (!opt->run_len) {
         return 0;
     }
-    if (disk_read_block(ctx, block)) {
+
+    uint32_t run_len = opt->run_len;
+    opt->run_len = 0;
+
+    if (bcache_read(ctx->cache, ctx->disk_offset + opt->run_block * ctx->disk_blocks,
+        run_len, opt->run_buf)) {
+        opt->buf_size += opt->buf - opt->run_buf;
+        opt->buf       = opt->run_buf;
         return -1;
     }
+
+    return 0;
+}
+
+/**
+ * @brief      copy part of file block to read buffer
+ *
+ * Whole blocks aren't copied right away, they are collected into runs of
+ * physically contiguous blocks read with a single ranged read.
+ *
+ * @return     0 on success
+ */
+static int read_block(ext2_ctx *ctx, file_read_opt *opt, uint32_t block,
+    uint32_t block_offset) {
     uint32_t to_read = opt->buf_size;
-    if (to_read > ctx->block_size) {
-        to_read = ctx->block_size;
+    if (to_read > ctx->block_size - block_offset) {
+        to_read = ctx->block_size - block_offset;
     }
-    memcpy(opt->buf, ctx->block + opt->block_offset, to_read);
-    opt->buf += to_read;
-    opt->buf_size -= to_read;
 
-    opt->block_offset = 0;
+    if (to_read == ctx->block_size) {
+        if (opt->run_len && block != opt->run_block + opt->run_len) {
+            if (flush_run(ctx, opt)) {
+                return -1;
+            }
+        }
+        if (!opt->run_len) {
+            opt->run_block = block;
+            opt->run_buf   = opt->buf;
+        }
+        opt->run_len++;
+    } else {
+        if (flush_run(ctx, opt)) {
+            return -1;
+        }
 
-    opt->block_num++;
+        const uint8_t *data = block_get(ctx, block);
+        if (!data) {
+            return -1;
+        }
+        memcpy(opt->buf, data + block_offset, to_read);
+        block_put(ctx, data);
+    }
+    opt->buf      += to_read;
+    opt->buf_size -= to_read;
 
-    //! stop reading, buffer filled
-    return (opt->buf_size ? 0 : -2);
+    return 0;
 }
 
-static int read_indirect_block(ext2_ctx *ctx, file_read_opt *opt, uint32_t block, uint8_t indirection) {
-    int ret = 0;
-    uint32_t *cached_block = NULL;
+/**
+ * @return     number of entries following `idx` which continue physical run
+ */
+static uint32_t block_run(const uint32_t *table, uint32_t idx, uint32_t count) {
+    uint32_t run = 1;
 
-    if (disk_read_block(ctx, block)) {
-        ret = -1;
-        goto end;
+    while (idx + run < count && table[idx + run] &&
+        table[idx + run] == table[idx] + run) {
+        run++;
     }
-    cached_block = malloc(ctx->block_size);
-    if (!cached_block) {
-        ret = -2;
-        goto end;
+
+    return run;
+}
+
+/**
+ * @brief      map file block to filesystem block walking inode block tables
+ *
+ * @param      ctx      ext2 context
+ * @param[in]  file     file inode
+ * @param[in]  logical  block index within file
+ * @param      run      number of physically contiguous blocks starting at
+ *                      result, within one block table (output)
+ *
+ * @return     filesystem block, 0 if block isn't allocated
+ */
+static uint32_t block_resolve(ext2_ctx *ctx, const inode *file, uint32_t logical,
+    uint32_t *run) {
+    *run = 1;
+
+    if (logical < INODE_DIRECT_BLOCKS) {
+        uint32_t block = file->block[logical];
+
+        while (block && logical + *run < INODE_DIRECT_BLOCKS &&
+            file->block[logical + *run] == block + *run) {
+            (*run)++;
+        }
+
+        return block;
     }
-    memcpy(cached_block, ctx->block, ctx->block_size);
-    for (uint32_t i = 0; i < ctx->block_size / sizeof(uint32_t); ++i) {
-        if (!cached_block[i]) {
-            ret = -3;
-            goto end;
+
+    uint32_t per_block = ctx->block_size / sizeof(uint32_t);
+    uint32_t span      = 1;
+
+    logical -= INODE_DIRECT_BLOCKS;
+
+    for (uint32_t level = 0; level < INODE_BLOCKS_TOTAL - INODE_DIRECT_BLOCKS; level++) {
+        //! file blocks covered by indirect block of this level
+        span *= per_block;
+
+        if (logical >= span) {
+            logical -= span;
+            continue;
         }
-        if (!indirection) {
-            if (read_direct_block(ctx, opt, cached_block[i])) {
-                ret = -4;
-                goto end;
+
+        uint32_t block = file->block[INODE_DIRECT_BLOCKS + level];
+
+        for (uint32_t depth = 0; depth <= level && block; depth++) {
+            const uint32_t *table = (const uint32_t *) block_get(ctx, block);
+            if (!table) {
+                return 0;
             }
-        } else {
-            if (read_indirect_block(ctx, opt, cached_block[i], indirection - 1)) {
-                ret = -5;
-                goto end;
+
+            span /= per_block;
+
+            block = table[logical / span];
+
+            if (depth == level && block) {
+                *run = block_run(table, logical, per_block);
             }
+
+            block_put(ctx, table);
+
+            logical %= span;
         }
+
+        return block;
     }
 
-    end:
+    return 0;
+}
+
+/**
+ * @return     filesystem block of mapped file block, 0 if not mapped
+ */
+static uint32_t map_lookup(const ext2_block_map *map, uint32_t logical, uint32_t *run) {
+    for (uint32_t i = 0; i < map->count; i++) {
+        const ext2_extent *extent = &map->extent[i];
+
+        if (logical >= extent->logical && logical - extent->logical < extent->len) {
+            *run = extent->len - (logical - extent->logical);
+
+            return extent->block + (logical - extent->logical);
+        }
+    }
+
+    return 0;
+}
+
+static void map_insert(ext2_block_map *map, uint32_t logical, uint32_t block, uint32_t len) {
+    //! continuation of known extent (next table of sequential file)
+    for (uint32_t i = 0; i < map->count; i++) {
+        ext2_extent *extent = &map->extent[i];
+
+        if (extent->logical + extent->len == logical &&
+            extent->block + extent->len == block) {
+            extent->len += len;
+            return;
+        }
+    }
 
-    if (cached_block) {
-        free(cached_block);
+    ext2_extent *extent;
+    if (map->count < EXT2_MAP_EXTENTS) {
+        extent = &map->extent[map->count++];
+    } else {
+        extent = &map->extent[map->victim];
+        map->victim = (map->victim + 1) % EXT2_MAP_EXTENTS;
     }
 
-    return ret;
+    extent->logical = logical;
+    extent->block   = block;
+    extent->len     = len;
 }
 
-static uint32_t read_file(ext2_ctx *ctx, uint8_t *buf, uint32_t buf_size,
-    uint32_t offset, inode *file) {
-    if (file->size < offset + buf_size) {
+/**
+ * @brief      map file block to filesystem block, block tables are walked
+ *             only for blocks not in file's block map yet
+ *
+ * @return     filesystem block, 0 if block isn't allocated
+ */
+static uint32_t file_block(ext2_ctx *ctx, ext2_desc_priv_data *priv,
+    const inode *file, uint32_t logical, uint32_t *run) {
+    if (!priv->map) {
+        //! works without the map too, just slower
+        priv->map = zmalloc(sizeof(ext2_block_map));
+    }
+
+    uint32_t block = priv->map ? map_lookup(priv->map, logical, run) : 0;
+    if (block) {
+        return block;
+    }
+
+    block = block_resolve(ctx, file, logical, run);
+    if (block && priv->map) {
+        map_insert(priv->map, logical, block, *run);
+    }
+
+    return block;
+}
+
+static uint32_t read_file(ext2_ctx *ctx, ext2_desc_priv_data *priv, const inode *file,
+    uint8_t *buf, uint32_t buf_size, uint32_t offset) {
+    if (offset >= file->size) {
+        return 0;
+    }
+    if (buf_size > file->size - offset) {
         buf_size = file->size - offset;
     }
     file_read_opt opt = {
-        .offset       = offset,
-        .block_offset = offset % ctx->block_size,
         .buf          = buf,
         .buf_size     = buf_size,
-        .block_num    = 0,
+        .run_len      = 0,
     };
-    for (unsigned i = 0; i < INODE_BLOCKS_TOTAL; i++) {
-        if (!file->block[i]) {
+
+    uint32_t logical      = offset / ctx->block_size;
+    uint32_t block_offset = offset % ctx->block_size;
+
+    while (opt.buf_size) {
+        uint32_t run;
+        uint32_t block = file_block(ctx, priv, file, logical, &run);
+        if (!block) {
             break;
         }
-        if (i < INODE_DIRECT_BLOCKS) {
-            if (read_direct_block(ctx, &opt, file->block[i])) {
-                break;
-            }
-        } else {
-            uint8_t indirection = i - INODE_DIRECT_BLOCKS;
-            if (read_indirect_block(ctx, &opt, file->block[i], indirection)) {
-                break;
+
+        for (uint32_t i = 0; i < run && opt.buf_size; i++) {
+            if (read_block(ctx, &opt, block + i, block_offset)) {
+                goto end;
             }
+
+            block_offset = 0;
+            logical++;
         }
     }
 
+    end:
+
+    flush_run(ctx, &opt);
+
     return (opt.buf - buf);
 }
 
-static inode *find_inode(ext2_ctx *ctx, uint32_t idx) {
-    uint32_t inode_group = (idx - 1) / ctx->sb.inode_per_group;
-    uint32_t inode_group_block = inode_group / (ctx->block_size / sizeof(block_group_desc_table));
+/**
+ * @brief      get block group descriptor
+ *
+ * Descriptor comes from the table loaded at init. Tables too large to be
+ * kept in memory are read through the block cache, one block at a time.
+ *
+ * @return     0 on success
+ */
+static int grp_desc_get(ext2_ctx *ctx, uint32_t group, block_group_desc_table *out) {
+    if (ctx->grp_desc) {
+        memcpy(out, &ctx->grp_desc[group], sizeof(block_group_desc_table));
+        return 0;
+    }
 
-    disk_read_block(ctx, ctx->block_desc_block + inode_group_block);
+    uint32_t per_block = ctx->block_size / sizeof(block_group_desc_table);
 
-    block_group_desc_table *desc = (void *) ctx->block;
-    desc += inode_group % (ctx->block_size / sizeof(block_group_desc_table));
+    const uint8_t *data = block_get(ctx, ctx->block_desc_block + group / per_block);
+    if (!data) {
+        return -1;
+    }
 
-    uint32_t used_inodes = ctx->sb.inode_per_group - desc->free_inodes_count;
-    uint32_t inode_table = desc->inode_table;
-    if (used_inodes) {
-        uint32_t index        = (idx - 1) % ctx->sb.inode_per_group;
-        uint32_t block        = (index * ctx->inode_size) / ctx->block_size;
+    memcpy(out, data + (group % per_block) * sizeof(block_group_desc_table),
+        sizeof(block_group_desc_table));
 
-        disk_read_block(ctx, inode_table + block);
+    block_put(ctx, data);
 
-        inode *inode = (void *) (ctx->block + (index * ctx->inode_size));
+    return 0;
+}
 
-        return inode;
+/**
+ * @brief      read inode from inode table
+ *
+ * @return     0 on success
+ */
+static int inode_load(ext2_ctx *ctx, uint32_t idx, inode *out) {
+    uint32_t inode_group = (idx - 1) / ctx->sb.inode_per_group;
+    if (inode_group >= ctx->grp_count) {
+        return -1;
     }
 
-    return NULL;
+    block_group_desc_table desc;
+    if (grp_desc_get(ctx, inode_group, &desc)) {
+        return -3;
+    }
+
+    if (ctx->sb.inode_per_group == desc.free_inodes_count) {
+        return -2;
+    }
+
+    uint32_t index = (idx - 1) % ctx->sb.inode_per_group;
+    uint32_t block = (index * ctx->inode_size) / ctx->block_size;
+
+    const uint8_t *data = block_get(ctx, desc.inode_table + block);
+    if (!data) {
+        return -3;
+    }
+
+    memcpy(out, data + (index * ctx->inode_size) % ctx->block_size, sizeof(inode));
+
+    block_put(ctx, data);
+
+    return 0;
 }
 
-static list_ifc *dir_attach_children(ext2_ctx *ctx, inode *ind, file_desc *parent) {
-    list_ifc *list = NULL;
+/**
+ * @brief      find inode, served from inode cache when possible
+ *
+ * @return     inode, valid until next inode_get call, NULL if not found
+ */
+static const inode *inode_get(ext2_ctx *ctx, uint32_t idx) {
+    if (!idx) {
+        return NULL;
+    }
 
-    if (disk_read_block(ctx, ind->block[0])) {
+    ext2_inode_slot *victim = &ctx->inode_cache[0];
+
+    for (uint32_t i = 0; i < EXT2_INODE_CACHE_SIZE; i++) {
+        ext2_inode_slot *slot = &ctx->inode_cache[i];
+
+        if (slot->idx == idx) {
+            slot->stamp = ++ctx->inode_clock;
+            return &slot->data;
+        }
+
+        //! empty slot has zero index and is always picked first
+        if (!slot->idx || (victim->idx && slot->stamp < victim->stamp)) {
+            victim = slot;
+        }
+    }
+
+    victim->idx = 0;
+
+    if (inode_load(ctx, idx, &victim->data)) {
         return NULL;
     }
 
-    uint8_t *cached_block = malloc(ctx->block_size);
-    if (!cached_block) {
-        goto end;
+    victim->idx   = idx;
+    victim->stamp = ++ctx->inode_clock;
+
+    return &victim->data;
+}
+
+/**
+ * @brief      load block group descriptor table
+ *
+ * Table which doesn't fit one heap cell isn't loaded, descriptors are
+ * read on demand then (see grp_desc_get).
+ *
+ * @return     0 on success
+ */
+static int grp_desc_load(ext2_ctx *ctx) {
+    if (!ctx->grp_count) {
+        return -3;
+    }
+
+    if (ctx->grp_count > UINT16_MAX / sizeof(block_group_desc_table)) {
+        ctx->grp_desc = NULL;
+        return 0;
+    }
+
+    uint32_t size  = ctx->grp_count * sizeof(block_group_desc_table);
+    uint32_t count = (size + ctx->block_size - 1) / ctx->block_size;
+
+    ctx->grp_desc = malloc(size);
+    if (!ctx->grp_desc) {
+        return -1;
+    }
+
+    uint8_t *dst = (uint8_t *) ctx->grp_desc;
+
+    for (uint32_t i = 0; i < count; i++) {
+        const uint8_t *data = block_get(ctx, ctx->block_desc_block + i);
+        if (!data) {
+            free(ctx->grp_desc);
+            ctx->grp_desc = NULL;
+            return -2;
+        }
+
+        uint32_t chunk = size > ctx->block_size ? ctx->block_size : size;
+
+        memcpy(dst, data, chunk);
+
+        block_put(ctx, data);
+
+        dst  += chunk;
+        size -= chunk;
     }
-    memcpy(cached_block, ctx->block, ctx->block_size);
 
+    return 0;
+}
+
+/**
+ * @brief      offset of ext2 data in descriptor
+ *
+ * Data follows the name, aligned for its members.
+ *
+ * @param[in]  name_size  name size, terminator included
+ */
+static uint32_t priv_offset(uint32_t name_size) {
+    uint32_t align = __alignof__(ext2_desc_priv_data);
+
+    return (offsetof(file_desc, name) + name_size + align - 1) & ~(align - 1);
+}
 
-    dir *dir = (void *) cached_block;
+/**
+ * @brief      build entry list of directory, subdirectories are left unloaded
+ *
+ * @param      ctx        filesystem context
+ * @param[in]  dir_block  first block of directory
+ * @param      parent     directory descriptor
+ *
+ * @return     entry list, NULL on failure
+ */
+static list_ifc *dir_attach_children(ext2_ctx *ctx, uint32_t dir_block, file_desc *parent) {
+    list_ifc *list = NULL;
+
+    const uint8_t *data = block_get(ctx, dir_block);
+    if (!data) {
+        return NULL;
+    }
+
+    const dir *dir = (const void *) data;
     uint32_t displacement = 0;
 
     while (displacement < ctx->block_size) {
@@ -417,17 +755,23 @@ static list_ifc *dir_attach_children(ext2_ctx *ctx, inode *ind, file_desc *paren
 
         if (type != F_TYPE_INV) {
             uint32_t name_size  = dir->name_len + 1;
-            uint32_t total_size = sizeof(file_desc) + name_size + sizeof(ext2_desc_priv_data);
+            uint32_t total_size = priv_offset(name_size) + sizeof(ext2_desc_priv_data);
 
             file_desc *node = malloc(total_size);
             if (!node || !list->insert_after(list, NULL, node)) {
+                if (node) {
+                    free(node);
+                }
                 list->destroy(list, free);
+                list = NULL;
                 goto end;
             }
 
-            ext2_desc_priv_data *priv = (ext2_desc_priv_data *) (node->name + name_size);
+            ext2_desc_priv_data *priv =
+                (ext2_desc_priv_data *) ((uint8_t *) node + priv_offset(name_size));
 
             priv->inode = dir->inode;
+            priv->map   = NULL;
 
             memcpy(node->name, dir->name, dir->name_len);
             node->name[dir->name_len] = 0;
@@ -442,37 +786,33 @@ static list_ifc *dir_attach_children(ext2_ctx *ctx, inode *ind, file_desc *paren
 
             node->child = NULL;
 
-            inode *entry = find_inode(ctx, dir->inode);
-            if (entry) {
-                int link = 0;
-                if (dir->name_len == 1 && !memcmp(dir->name, ".", dir->name_len)) {
-                    link = 1;
-                    //! self link
-                    node->link = node;
-                }
-                if (dir->name_len == 2 && !memcmp(dir->name, "..", dir->name_len)) {
-                    link = 1;
-                    //! parent link
-                    node->link = parent;
-                }
-                if (type == F_TYPE_DIR && !link) {
-                    node->child = dir_attach_children(ctx, entry, node);
-                } else if (type == F_TYPE_REG) {
+            if (dir->name_len == 1 && !memcmp(dir->name, ".", dir->name_len)) {
+                //! self link
+                node->link = node;
+            } else if (dir->name_len == 2 && !memcmp(dir->name, "..", dir->name_len)) {
+                //! parent link
+                node->link = parent;
+            } else if (type == F_TYPE_REG) {
+                //! inode is only needed for file size
+                const inode *entry = inode_get(ctx, dir->inode);
+                if (entry) {
                     node->size = entry->size;
                 }
             }
         }
 
+        if (!dir->rec_len) {
+            break;
+        }
+
         displacement += dir->rec_len;
 
-        dir = (void *) (cached_block + displacement);
+        dir = (const void *) (data + displacement);
     }
 
     end:
 
-    if (cached_block) {
-        free(cached_block);
-    }
+    block_put(ctx, data);
 
     return list;
 }
@@ -483,50 +823,60 @@ static file_desc *ext2_mount(fs_ifc *ifc, const char *root_path) {
         return NULL;
     }
 
-    inode *inode = find_inode(ctx, ROOT_INODE);
-    if (!inode) {
+    if (!inode_get(ctx, ROOT_INODE)) {
         return NULL;
     }
 
     uint32_t name_size  = strsize(root_path);
-    uint32_t total_size = sizeof(file_desc) + name_size + sizeof(ext2_desc_priv_data);
+    uint32_t total_size = priv_offset(name_size) + sizeof(ext2_desc_priv_data);
 
     file_desc *root = malloc(total_size);
     if (!root) {
         return NULL;
     }
 
-    ext2_desc_priv_data *priv = (ext2_desc_priv_data *) (root->name + name_size);
+    ext2_desc_priv_data *priv =
+        (ext2_desc_priv_data *) ((uint8_t *) root + priv_offset(name_size));
 
     priv->inode = ROOT_INODE;
+    priv->map   = NULL;
 
     strcpy(root->name, root_path);
     root->desc_size = total_size;
     root->type      = F_TYPE_DIR;
     root->size      = 0;
-    root->child     = dir_attach_children(ctx, inode, root);
+    root->link      = NULL;
+    //! entries are loaded on first access
+    root->child     = NULL;
 
     return root;
 }
 
-static int ext2_read_file(ext2_ctx *ctx, file_desc *file, uint8_t *buf, uint32_t buf_size, uint32_t offset) {
+/**
+ * @return     ext2 data of file descriptor, NULL if descriptor isn't valid
+ */
+static ext2_desc_priv_data *desc_priv(file_desc *file) {
     uint32_t name_size = strsize(file->name);
-    if (file->desc_size != sizeof(file_desc) + name_size + sizeof(ext2_desc_priv_data)) {
+    if (file->desc_size != priv_offset(name_size) + sizeof(ext2_desc_priv_data)) {
+        return NULL;
+    }
+
+    return (ext2_desc_priv_data *) ((uint8_t *) file + priv_offset(name_size));
+}
+
+static int ext2_read_file(ext2_ctx *ctx, file_desc *file, uint8_t *buf, uint32_t buf_size, uint32_t offset) {
+    ext2_desc_priv_data *priv = desc_priv(file);
+    if (!priv) {
         //! doesn't seem to be valid
         return -4;
     }
 
-    ext2_desc_priv_data *priv = (ext2_desc_priv_data *) (file->name + name_size);
-
-    inode *entry = find_inode(ctx, priv->inode);
+    const inode *entry = inode_get(ctx, priv->inode);
     if (!entry) {
         return -5;
     }
 
-    inode saved_inode;
-    memcpy(&saved_inode, entry, sizeof(inode));
-
-    return read_file(ctx, buf, buf_size, offset, &saved_inode);
+    return read_file(ctx, priv, entry, buf, buf_size, offset);
 }
 
 static int ext2_read_dir(file_desc *file, uint8_t *buf, uint32_t buf_size, uint32_t offset) {
@@ -592,37 +942,152 @@ static int ext2_read(fs_ifc *ifc, file_desc *file, uint8_t *buf, uint32_t buf_si
     return -4;
 }
 
-fs_ifc *ext2_init(disk_ifc *disk, uint32_t disk_blk) {
-    if (!disk) {
+static int ext2_prefetch(fs_ifc *ifc, file_desc *file, uint32_t offset, uint32_t size) {
+    ext2_ctx *ctx = (ext2_ctx *) ifc;
+    if (!ctx || !file || file->type != F_TYPE_REG) {
+        return -1;
+    }
+
+    ext2_desc_priv_data *priv = desc_priv(file);
+    if (!priv) {
+        return -2;
+    }
+
+    const inode *entry = inode_get(ctx, priv->inode);
+    if (!entry) {
+        return -3;
+    }
+
+    if (offset >= entry->size || !size) {
         return 0;
     }
 
-    disk_stat disk_stat;
-    disk->get_stat(disk, &disk_stat);
+    if (size > entry->size - offset) {
+        size = entry->size - offset;
+    }
 
-    uint32_t to_read = SB_SIZE * 2;
-    uint8_t *sb_buf = malloc(to_read);
-    if (!sb_buf) {
-        return NULL;
+    uint32_t logical = offset / ctx->block_size;
+    uint32_t last    = (offset + size - 1) / ctx->block_size;
+
+    int loaded = 0;
+
+    //! physically contiguous blocks are loaded with one transfer
+    while (logical <= last) {
+        uint32_t run;
+        uint32_t block = file_block(ctx, priv, entry, logical, &run);
+        if (!block) {
+            break;
+        }
+
+        if (run > last - logical + 1) {
+            run = last - logical + 1;
+        }
+
+        int ret = bcache_prefetch(ctx->cache,
+            ctx->disk_offset + block * ctx->disk_blocks, run);
+        if (ret < 0) {
+            return -4;
+        }
+
+        loaded  += ret;
+        logical += run;
     }
 
-    uint32_t disk_offset = disk_blk;
+    return loaded;
+}
 
-    uint8_t *ptr = sb_buf;
-    while (to_read) {
-        if (disk->read(disk, disk_blk, ptr)) {
-            free(sb_buf);
-            return NULL;
+static int ext2_load(fs_ifc *ifc, file_desc *dir) {
+    ext2_ctx *ctx = (ext2_ctx *) ifc;
+    if (!ctx || !dir || dir->type != F_TYPE_DIR) {
+        return -1;
+    }
+
+    if (dir->child) {
+        return 0;
+    }
+
+    ext2_desc_priv_data *priv = desc_priv(dir);
+    if (!priv) {
+        return -2;
+    }
+
+    const inode *entry = inode_get(ctx, priv->inode);
+    if (!entry) {
+        return -3;
+    }
+
+    dir->child = dir_attach_children(ctx, entry->block[0], dir);
+
+    return dir->child ? 0 : -4;
+}
+
+static void ext2_unload(fs_ifc *ifc, file_desc *dir) {
+    if (!dir || !dir->child) {
+        return;
+    }
+
+    //! loaded subdirectories go together with their parent
+    const list_node *node = dir->child->get_front(dir->child);
+    while (node) {
+        file_desc *entry = node->ptr;
+        if (entry->type == F_TYPE_DIR && !entry->link) {
+            ext2_unload(ifc, entry);
         }
-        disk_blk++;
-        ptr += disk_stat.block_size;
-        to_read -= disk_stat.block_size;
+
+        node = node->nxt;
     }
 
-    ext2_superblock *sb_data = (ext2_superblock *) (sb_buf + SB_OFFSET);
+    dir->child->destroy(dir->child, free);
+    dir->child = NULL;
+}
+
+static void ext2_release(fs_ifc *ifc, file_desc *file) {
+    (void) ifc;
+
+    if (!file) {
+        return;
+    }
+
+    ext2_desc_priv_data *priv = desc_priv(file);
+    if (priv && priv->map) {
+        free(priv->map);
+        priv->map = NULL;
+    }
+}
+
+static void ext2_destroy(fs_ifc *ifc) {
+    ext2_ctx *ctx = (ext2_ctx *) ifc;
+    if (!ctx) {
+        return;
+    }
+
+    if (ctx->grp_desc) {
+        free(ctx->grp_desc);
+    }
+
+    free(ctx);
+}
+
+fs_ifc *ext2_init(bcache *cache, uint32_t disk_blk) {
+    if (!cache) {
+        return 0;
+    }
+
+    uint32_t cache_block_size = bcache_block_size(cache);
+    uint32_t disk_block_size  = bcache_disk_block_size(cache);
+    if (cache_block_size < SB_SIZE || SB_OFFSET % disk_block_size) {
+        return NULL;
+    }
+
+    const uint8_t *sb_buf = bcache_get(cache, disk_blk + SB_OFFSET / disk_block_size);
+    if (!sb_buf) {
+        return NULL;
+    }
+
+    const ext2_superblock *sb_data = (const ext2_superblock *) sb_buf;
 
     if (sb_data->magic != EXT2_MAGIC) {
-        free(sb_buf);
+        bcache_put(cache, sb_buf);
         return NULL;
     }
 
@@ -637,26 +1102,35 @@ fs_ifc *ext2_init(disk_ifc *disk, uint32_t disk_blk) {
     }
 
     if (group_count_blocks != group_count_inodes) {
-        free(sb_buf);
+        bcache_put(cache, sb_buf);
         return NULL;
     }
 
     uint32_t block_size = (LOG_SIZE_BASE << sb_data->log_block_size);
 
-    free(sb_buf);
-
-    ext2_ctx *ctx = malloc(sizeof(ext2_ctx) + block_size);
+    ext2_ctx *ctx = malloc(sizeof(ext2_ctx));
     if (!ctx) {
+        bcache_put(cache, sb_buf);
         return NULL;
     }
 
-    ctx->disk = disk;
+    memcpy(&ctx->sb, sb_data, sizeof(ext2_superblock));
 
-    ctx->disk_offset = disk_offset;
+    bcache_put(cache, sb_buf);
 
-    ctx->block_size = block_size;
+    //! cache block follows filesystem block
+    if (bcache_block_size_set(cache, block_size)) {
+        free(ctx);
+        return NULL;
+    }
 
-    memcpy(&ctx->sb, sb_data, sizeof(ext2_superblock));
+    ctx->cache = cache;
+
+    ctx->disk_offset = disk_blk;
+
+    ctx->disk_blocks = block_size / disk_block_size;
+
+    ctx->block_size = block_size;
 
     ctx->grp_count = group_count_blocks;
 
@@ -665,8 +1139,22 @@ fs_ifc *ext2_init(disk_ifc *disk, uint32_t disk_blk) {
 
     ctx->block_desc_block = !ctx->sb.log_block_size + 1;
 
-    ctx->ifc.mount = ext2_mount;
-    ctx->ifc.read  = ext2_read;
+    ctx->inode_clock = 0;
+
+    memset(ctx->inode_cache, 0, sizeof(ctx->inode_cache));
+
+    if (grp_desc_load(ctx)) {
+        free(ctx);
+        return NULL;
+    }
+
+    ctx->ifc.mount    = ext2_mount;
+    ctx->ifc.read     = ext2_read;
+    ctx->ifc.prefetch = ext2_prefetch;
+    ctx->ifc.release  = ext2_release;
+    ctx->ifc.load     = ext2_load;
+    ctx->ifc.unload   = ext2_unload;
+    ctx->ifc.destroy  = ext2_destroy;
 
     return &ctx->ifc;
 }
@@ -0,0 +1,33 @@
+#ifndef DRIVER_RAM_DISK_H
+#define DRIVER_RAM_DISK_H
+
+#include "common/common.h"
+#include "driver/disk.h"
+
+#define RAM_DISK_BLOCK_SIZE 512
+
+typedef struct ram_disk_config_t {
+    /**
+     * disk image, zeroed memory is allocated if NULL (image has to fit
+     * one heap cell then, i.e. less than 64 KiB)
+     */
+    uint8_t          *image;
+    uint32_t          blocks;
+    /**
+     * injected per-block access latency in microseconds (0 - none),
+     * user threads get millisecond resolution
+     */
+    uint32_t          read_latency_us;
+    uint32_t          write_latency_us;
+} ram_disk_config;
+
+/**
+ * @brief      initialize RAM disk
+ *
+ * @param[in]  cfg   disk configuration
+ *
+ * @return     disk interface, NULL on failure
+ */
+disk_ifc *ram_disk_init(const ram_disk_config *cfg);
+
+#endif
@@ -0,0 +1,66 @@
+#ifndef DRIVER_SD_EMU_H
+#define DRIVER_SD_EMU_H
+
+#include "common/common.h"
+#include "platform/spi.h"
+#include "driver/disk.h"
+
+/**
+ * SPI-mode SDHC card model
+ *
+ * Emulator is an SPI interface: every byte clocked by the host is fed to
+ * the card state machine and the byte card drives on DO is returned.
+ * Supported: CMD0/8/9/12/16/17/18/24/25/55/58/59 and ACMD41, CRC7 of
+ * commands and CRC16 of written data are verified.
+ */
+typedef struct sd_emu_config_t {
+    /**
+     * backing disk, 512 byte blocks
+     */
+    disk_ifc         *disk;
+    /**
+     * injected time per command in microseconds (0 - none),
+     * user threads get millisecond resolution
+     */
+    uint32_t          cmd_latency_us;
+    /**
+     * 0xff bytes before data token of each read block (Nac)
+     */
+    uint32_t          access_bytes;
+    /**
+     * busy bytes after written block and after stop
+     */
+    uint32_t          busy_bytes;
+    /**
+     * ACMD41 polls reporting idle before initialization completes
+     */
+    uint32_t          init_polls;
+} sd_emu_config;
+
+typedef struct sd_emu_stat_t {
+    uint32_t          commands;
+    uint32_t          crc_errors;
+    /**
+     * bytes clocked while card was selected
+     */
+    uint32_t          bytes;
+} sd_emu_stat;
+
+/**
+ * @brief      create emulated card
+ *
+ * @param[in]  cfg   emulator configuration
+ *
+ * @return     SPI interface of the card, NULL on failure
+ */
+spi_iface *sd_emu_init(const sd_emu_config *cfg);
+
+/**
+ * @brief      get emulator counters
+ *
+ * @param      spi   emulated card
+ * @param      stat  counters
+ */
+void sd_emu_stat_get(spi_iface *spi, sd_emu_stat *stat);
+
+#endif
@@ -5,6 +5,22 @@
 #include "platform/spi.h"
 #include "driver/disk.h"
 
+/**
+ * @brief      initialize SD card on target SD SPI bus
+ *
+ * @param[in]  cfg   SPI configuration
+ *
+ * @return     disk interface, NULL on failure
+ */
 disk_ifc *sd_spi_init(const spi_config *cfg);
 
+/**
+ * @brief      initialize SD card on already configured SPI interface
+ *
+ * @param      spi   SPI interface (hardware or emulated card)
+ *
+ * @return     disk interface, NULL on failure
+ */
+disk_ifc *sd_spi_attach(spi_iface *spi);
+
 #endif
\ No newline at end of file
@@ -0,0 +1,443 @@
+#include "driver/bcache.h"
+#include "kernel/syscall.h"
+
+typedef struct bcache_slot_t {
+    uint32_t         blk;
+    uint16_t         pins;
+    uint8_t          valid;
+    //! CLOCK reference bit
+    uint8_t          ref;
+    //! loaded by read-ahead and not used yet
+    uint8_t          ahead;
+} bcache_slot;
+
+struct bcache_t {
+    disk_ifc        *disk;
+    uint32_t         disk_block_size;
+    uint32_t         block_size;
+    uint32_t         slot_count;
+    //! read-ahead slots, placed after CLOCK slots
+    uint32_t         ahead_count;
+    //! CLOCK hand
+    uint32_t         hand;
+    //! next read-ahead slot to be reused
+    uint32_t         ahead_hand;
+    bcache_stat      stat;
+    uint8_t         *pool;
+    bcache_slot      slot[];
+};
+
+static inline
+uint8_t *slot_data(bcache *cache, uint32_t idx) {
+    return cache->pool + idx * cache->block_size;
+}
+
+static inline
+uint32_t slot_total(bcache *cache) {
+    return cache->slot_count + cache->ahead_count;
+}
+
+static
+int slot_fill(bcache *cache, uint32_t idx, uint32_t blk) {
+    uint32_t count = cache->block_size / cache->disk_block_size;
+
+    if (cache->disk->read_blocks(cache->disk, blk, count, slot_data(cache, idx))) {
+        return -1;
+    }
+
+    cache->stat.disk_reads += count;
+
+    return 0;
+}
+
+/**
+ * @return     index of slot holding the block, negative if not cached
+ */
+static
+int slot_find(bcache *cache, uint32_t blk) {
+    for (uint32_t idx = 0; idx < slot_total(cache); idx++) {
+        if (cache->slot[idx].valid && cache->slot[idx].blk == blk) {
+            return idx;
+        }
+    }
+
+    return -1;
+}
+
+/**
+ * @brief      pick slot to be replaced
+ *
+ * @return     slot index, negative if every slot is pinned
+ */
+static
+int slot_victim(bcache *cache) {
+    //! two turns: first one may only clear reference bits
+    for (uint32_t step = 0; step < cache->slot_count * 2; step++) {
+        uint32_t     idx  = cache->hand;
+        bcache_slot *slot = &cache->slot[idx];
+
+        cache->hand = (idx + 1) % cache->slot_count;
+
+        if (slot->pins) {
+            continue;
+        }
+
+        if (!slot->valid) {
+            return idx;
+        }
+
+        if (slot->ref) {
+            slot->ref = 0;
+            continue;
+        }
+
+        cache->stat.evictions++;
+
+        return idx;
+    }
+
+    return -1;
+}
+
+/**
+ * @brief      take read-ahead slots for a run of blocks, oldest one first
+ *
+ * Taken slots are adjacent in the pool, so the run is read into them with
+ * a single transfer. Fewer slots are taken at the end of the read-ahead
+ * area and in front of a pinned slot.
+ *
+ * @param[in]  run    number of blocks to be loaded
+ * @param      first  index of the first taken slot (output)
+ *
+ * @return     number of slots taken, 0 if every read-ahead slot is pinned
+ */
+static
+uint32_t slot_ahead(bcache *cache, uint32_t run, uint32_t *first) {
+    uint32_t taken = 0;
+
+    for (uint32_t step = 0; step < cache->ahead_count && taken < run; step++) {
+        uint32_t     idx  = cache->slot_count + cache->ahead_hand;
+        bcache_slot *slot = &cache->slot[idx];
+
+        if (slot->pins && taken) {
+            break;
+        }
+
+        cache->ahead_hand = (cache->ahead_hand + 1) % cache->ahead_count;
+
+        if (slot->pins) {
+            continue;
+        }
+
+        if (slot->valid && slot->ahead) {
+            cache->stat.prefetch_wasted++;
+        }
+
+        if (!taken) {
+            *first = idx;
+        }
+
+        slot->valid = 0;
+        taken++;
+
+        //! slots past the wrap point aren't adjacent
+        if (!cache->ahead_hand) {
+            break;
+        }
+    }
+
+    return taken;
+}
+
+static
+int pool_alloc(bcache *cache, uint32_t block_size) {
+    //! pool is a single heap cell, those are at most 64 KiB
+    if (block_size > UINT16_MAX / slot_total(cache)) {
+        return -1;
+    }
+
+    uint8_t *pool = malloc(block_size * slot_total(cache));
+    if (!pool) {
+        return -1;
+    }
+
+    if (cache->pool) {
+        free(cache->pool);
+    }
+
+    cache->pool       = pool;
+    cache->block_size = block_size;
+    cache->hand       = 0;
+    cache->ahead_hand = 0;
+
+    memset(cache->slot, 0, sizeof(bcache_slot) * slot_total(cache));
+
+    return 0;
+}
+
+bcache *bcache_create(disk_ifc *disk, uint32_t block_size, uint32_t slot_count,
+    uint32_t ahead_count) {
+    if (!disk || !block_size || !slot_count) {
+        return NULL;
+    }
+
+    disk_stat disk_stat;
+    if (disk->get_stat(disk, &disk_stat) || !disk_stat.block_size ||
+        block_size % disk_stat.block_size) {
+        return NULL;
+    }
+
+    bcache *cache = malloc(sizeof(bcache) +
+        sizeof(bcache_slot) * (slot_count + ahead_count));
+    if (!cache) {
+        return NULL;
+    }
+
+    cache->disk            = disk;
+    cache->disk_block_size = disk_stat.block_size;
+    cache->slot_count      = slot_count;
+    cache->ahead_count     = ahead_count;
+    cache->pool            = NULL;
+
+    memset(&cache->stat, 0, sizeof(bcache_stat));
+
+    if (pool_alloc(cache, block_size)) {
+        free(cache);
+        return NULL;
+    }
+
+    return cache;
+}
+
+void bcache_destroy(bcache *cache) {
+    if (!cache) {
+        return;
+    }
+
+    free(cache->pool);
+    free(cache);
+}
+
+int bcache_block_size_set(bcache *cache, uint32_t block_size) {
+    if (!cache || !block_size || block_size % cache->disk_block_size) {
+        return -1;
+    }
+
+    for (uint32_t idx = 0; idx < slot_total(cache); idx++) {
+        if (cache->slot[idx].pins) {
+            return -2;
+        }
+    }
+
+    if (block_size == cache->block_size) {
+        bcache_invalidate(cache);
+        return 0;
+    }
+
+    return pool_alloc(cache, block_size) ? -3 : 0;
+}
+
+uint32_t bcache_block_size(bcache *cache) {
+    return cache ? cache->block_size : 0;
+}
+
+uint32_t bcache_disk_block_size(bcache *cache) {
+    return cache ? cache->disk_block_size : 0;
+}
+
+const uint8_t *bcache_get(bcache *cache, uint32_t blk) {
+    if (!cache) {
+        return NULL;
+    }
+
+    int idx = slot_find(cache, blk);
+    if (idx >= 0) {
+        cache->stat.hits++;
+
+        cache->slot[idx].ref   = 1;
+        cache->slot[idx].ahead = 0;
+        cache->slot[idx].pins++;
+
+        return slot_data(cache, idx);
+    }
+
+    cache->stat.misses++;
+
+    idx = slot_victim(cache);
+    if (idx < 0) {
+        return NULL;
+    }
+
+    bcache_slot *slot = &cache->slot[idx];
+
+    slot->valid = 0;
+
+    if (slot_fill(cache, idx, blk)) {
+        return NULL;
+    }
+
+    slot->blk   = blk;
+    slot->valid = 1;
+    slot->ref   = 1;
+    slot->ahead = 0;
+    slot->pins  = 1;
+
+    return slot_data(cache, idx);
+}
+
+void bcache_put(bcache *cache, const void *data) {
+    if (!cache || !data) {
+        return;
+    }
+
+    const uint8_t *ptr = data;
+    if (ptr < cache->pool) {
+        return;
+    }
+
+    uint32_t idx = (ptr - cache->pool) / cache->block_size;
+    if (idx < slot_total(cache) && cache->slot[idx].pins) {
+        cache->slot[idx].pins--;
+    }
+}
+
+void bcache_invalidate(bcache *cache) {
+    if (!cache) {
+        return;
+    }
+
+    for (uint32_t idx = 0; idx < slot_total(cache); idx++) {
+        if (!cache->slot[idx].pins) {
+            cache->slot[idx].valid = 0;
+        }
+    }
+}
+
+int bcache_read(bcache *cache, uint32_t blk, uint32_t count, uint8_t *buf) {
+    if (!cache || !buf) {
+        return -1;
+    }
+
+    uint32_t step = cache->block_size / cache->disk_block_size;
+
+    while (count) {
+        int idx = slot_find(cache, blk);
+        if (idx >= 0) {
+            cache->stat.hits++;
+            cache->slot[idx].ref   = 1;
+            cache->slot[idx].ahead = 0;
+
+            memcpy(buf, slot_data(cache, idx), cache->block_size);
+
+            blk += step;
+            buf += cache->block_size;
+            count--;
+            continue;
+        }
+
+        //! stream the whole uncached run, streamed data is not cached
+        uint32_t run = 1;
+        while (run < count && slot_find(cache, blk + run * step) < 0) {
+            run++;
+        }
+
+        cache->stat.misses += run;
+
+        if (cache->disk->read_blocks(cache->disk, blk, run * step, buf)) {
+            return -2;
+        }
+
+        cache->stat.disk_reads += run * step;
+
+        blk   += run * step;
+        buf   += run * cache->block_size;
+        count -= run;
+    }
+
+    return 0;
+}
+
+int bcache_prefetch(bcache *cache, uint32_t blk, uint32_t count) {
+    if (!cache) {
+        return -1;
+    }
+
+    if (count > cache->ahead_count) {
+        count = cache->ahead_count;
+    }
+
+    uint32_t step   = cache->block_size / cache->disk_block_size;
+    uint32_t loaded = 0;
+
+    //! each unpinned read-ahead slot is reused once at most, so blocks
+    //! loaded by this call aren't replaced by the following ones
+    uint32_t room = 0;
+    for (uint32_t idx = cache->slot_count; idx < slot_total(cache); idx++) {
+        if (!cache->slot[idx].pins) {
+            room++;
+        }
+    }
+
+    while (count && loaded < room) {
+        if (slot_find(cache, blk) >= 0) {
+            blk += step;
+            count--;
+            continue;
+        }
+
+        uint32_t run = 1;
+        while (run < count && slot_find(cache, blk + run * step) < 0) {
+            run++;
+        }
+
+        if (run > room - loaded) {
+            run = room - loaded;
+        }
+
+        uint32_t first = 0;
+        uint32_t taken = slot_ahead(cache, run, &first);
+        if (!taken) {
+            break;
+        }
+
+        //! straight into the pool, taken slots are adjacent
+        if (cache->disk->read_blocks(cache->disk, blk, taken * step,
+            slot_data(cache, first))) {
+            return -2;
+        }
+
+        cache->stat.disk_reads += taken * step;
+
+        for (uint32_t i = 0; i < taken; i++) {
+            bcache_slot *slot = &cache->slot[first + i];
+
+            slot->blk   = blk + i * step;
+            slot->valid = 1;
+            slot->ahead = 1;
+        }
+
+        cache->stat.prefetched += taken;
+        loaded                 += taken;
+
+        blk   += taken * step;
+        count -= taken;
+    }
+
+    return loaded;
+}
+
+int bcache_stat_get(bcache *cache, bcache_stat *stat) {
+    if (!cache || !stat) {
+        return -1;
+    }
+
+    memcpy(stat, &cache->stat, sizeof(bcache_stat));
+
+    return 0;
+}
+
+void bcache_stat_reset(bcache *cache) {
+    if (cache) {
+        memset(&cache->stat, 0, sizeof(bcache_stat));
+    }
+}
@@ -0,0 +1,128 @@
+#include "driver/ram_disk.h"
+#include "kernel/syscall.h"
+#include "platform/clock.h"
+
+typedef struct ram_disk_ctx_t {
+    disk_ifc          ifc;
+    ram_disk_config   cfg;
+    //! image is owned by the disk
+    uint8_t           own;
+} ram_disk_ctx;
+
+/**
+ * @brief      spin for injected access latency
+ */
+static void ram_disk_delay(uint32_t latency_us) {
+    if (!latency_us) {
+        return;
+    }
+
+    uint32_t start = clock_get_us();
+    while (clock_get_us() - start < latency_us);
+}
+
+static int ram_disk_read_blocks(disk_ifc *ifc, uint32_t blk, uint32_t count, uint8_t *buf) {
+    ram_disk_ctx *ctx = (ram_disk_ctx *) ifc;
+    if (!ctx || !buf) {
+        return -1;
+    }
+
+    if (blk >= ctx->cfg.blocks || count > ctx->cfg.blocks - blk) {
+        return -2;
+    }
+
+    ram_disk_delay(ctx->cfg.read_latency_us * count);
+
+    memcpy(buf, ctx->cfg.image + blk * RAM_DISK_BLOCK_SIZE, count * RAM_DISK_BLOCK_SIZE);
+
+    return 0;
+}
+
+static int ram_disk_write_blocks(disk_ifc *ifc, uint32_t blk, uint32_t count, const uint8_t *buf) {
+    ram_disk_ctx *ctx = (ram_disk_ctx *) ifc;
+    if (!ctx || !buf) {
+        return -1;
+    }
+
+    if (blk >= ctx->cfg.blocks || count > ctx->cfg.blocks - blk) {
+        return -2;
+    }
+
+    ram_disk_delay(ctx->cfg.write_latency_us * count);
+
+    memcpy(ctx->cfg.image + blk * RAM_DISK_BLOCK_SIZE, buf, count * RAM_DISK_BLOCK_SIZE);
+
+    return 0;
+}
+
+static int ram_disk_read(disk_ifc *ifc, uint32_t blk, uint8_t *buf) {
+    return ram_disk_read_blocks(ifc, blk, 1, buf);
+}
+
+static int ram_disk_write(disk_ifc *ifc, uint32_t blk, const uint8_t *buf) {
+    return ram_disk_write_blocks(ifc, blk, 1, buf);
+}
+
+static int ram_disk_get_stat(disk_ifc *ifc, disk_stat *stat) {
+    ram_disk_ctx *ctx = (ram_disk_ctx *) ifc;
+    if (!ctx || !stat) {
+        return -1;
+    }
+
+    stat->size_mb    = (ctx->cfg.blocks * RAM_DISK_BLOCK_SIZE) >> 20;
+    stat->block_size = RAM_DISK_BLOCK_SIZE;
+    stat->blocks     = ctx->cfg.blocks;
+
+    return 0;
+}
+
+static void ram_disk_destroy(disk_ifc *ifc) {
+    ram_disk_ctx *ctx = (ram_disk_ctx *) ifc;
+    if (!ctx) {
+        return;
+    }
+
+    if (ctx->own) {
+        free(ctx->cfg.image);
+    }
+
+    free(ctx);
+}
+
+disk_ifc *ram_disk_init(const ram_disk_config *cfg) {
+    if (!cfg || !cfg->blocks) {
+        return NULL;
+    }
+
+    ram_disk_ctx *ctx = malloc(sizeof(ram_disk_ctx));
+    if (!ctx) {
+        return NULL;
+    }
+
+    memcpy(&ctx->cfg, cfg, sizeof(ram_disk_config));
+
+    ctx->own = !cfg->image;
+
+    //! heap cells are at most 64 KiB
+    if (ctx->own && cfg->blocks > UINT16_MAX / RAM_DISK_BLOCK_SIZE) {
+        free(ctx);
+        return NULL;
+    }
+
+    if (ctx->own) {
+        ctx->cfg.image = zmalloc(cfg->blocks * RAM_DISK_BLOCK_SIZE);
+        if (!ctx->cfg.image) {
+            free(ctx);
+            return NULL;
+        }
+    }
+
+    ctx->ifc.read         = ram_disk_read;
+    ctx->ifc.write        = ram_disk_write;
+    ctx->ifc.read_blocks  = ram_disk_read_blocks;
+    ctx->ifc.write_blocks = ram_disk_write_blocks;
+    ctx->ifc.get_stat     = ram_disk_get_stat;
+    ctx->ifc.destroy      = ram_disk_destroy;
+
+    return &ctx->ifc;
+}
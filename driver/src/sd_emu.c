@@ -0,0 +1,557 @@
+#ifdef SD_EMU
+
+#include "driver/sd_emu.h"
+#include "kernel/syscall.h"
+#include "platform/clock.h"
+
+#define EMU_BLOCK_SIZE     512
+#define EMU_CMD_SIZE       6
+#define EMU_RESP_MAX       8
+#define EMU_CSD_SIZE       16
+
+#define CMD_START_MASK     0xc0
+#define CMD_START          0x40
+#define CMD_INDEX_MASK     0x3f
+
+#define R1_IDLE            (1 << 0)
+#define R1_ILLEGAL_CMD     (1 << 2)
+#define R1_CRC_ERR         (1 << 3)
+#define R1_ADDR_ERR        (1 << 5)
+#define R1_PARAM_ERR       (1 << 6)
+
+#define START_BLOCK_TOK    0xfe
+#define START_MULTI_TOK    0xfc
+#define STOP_TRAN_TOK      0xfd
+
+#define DATA_ACCEPTED      0x05
+#define DATA_CRC_ERR       0x0b
+#define DATA_WRITE_ERR     0x0d
+
+//! CMD12 stuff byte, bit 7 clear so a host which doesn't skip it fails
+#define STUFF_BYTE         0x3f
+
+//! OCR: power up done, CCS (high capacity), 2.7-3.6V
+#define OCR_READY          0xc0ff8000
+#define OCR_BUSY           0x40ff8000
+
+typedef enum emu_state_t {
+    EMU_CMD,
+    EMU_RESP,
+    EMU_READ,
+    EMU_WRITE,
+    EMU_WRITE_DATA,
+    EMU_BUSY,
+} emu_state;
+
+typedef enum emu_read_phase_t {
+    READ_ACCESS,
+    READ_STALL,
+    READ_DATA,
+    READ_CRC_HI,
+    READ_CRC_LO,
+} emu_read_phase;
+
+typedef struct sd_emu_ctx_t {
+    spi_iface         iface;
+    sd_emu_config     cfg;
+    sd_emu_stat       stat;
+    uint32_t          blocks;
+
+    uint8_t           cs;
+    uint8_t           idle;
+    uint8_t           app_cmd;
+    uint8_t           multi;
+    uint32_t          init_left;
+
+    emu_state         state;
+    //! state entered once queued bytes and busy are shifted out
+    emu_state         next;
+
+    uint8_t           cmd[EMU_CMD_SIZE];
+    uint32_t          cmd_pos;
+
+    uint8_t           resp[EMU_RESP_MAX];
+    uint32_t          resp_len;
+    uint32_t          resp_pos;
+
+    uint32_t          busy_left;
+
+    emu_read_phase    phase;
+    uint32_t          wait_left;
+    uint32_t          blk;
+    uint32_t          data_len;
+    uint32_t          data_pos;
+    uint16_t          crc;
+    //! block data + CRC
+    uint8_t           data[EMU_BLOCK_SIZE + 2];
+} sd_emu_ctx;
+
+static uint8_t emu_crc7(const uint8_t *buf, uint32_t len) {
+    uint8_t crc = 0;
+
+    while (len--) {
+        uint8_t byte = *buf++;
+        for (int i = 0; i < 8; i++) {
+            crc <<= 1;
+            if ((byte ^ crc) & 0x80) {
+                crc ^= 0x09;
+            }
+            byte <<= 1;
+        }
+    }
+
+    return ((crc & 0x7f) << 1) | 0x01;
+}
+
+static uint16_t emu_crc16(const uint8_t *buf, uint32_t len) {
+    uint16_t crc = 0;
+
+    while (len--) {
+        crc ^= (uint16_t) *buf++ << 8;
+        for (int i = 0; i < 8; i++) {
+            crc = crc & 0x8000 ? (crc << 1) ^ 0x1021 : crc << 1;
+        }
+    }
+
+    return crc;
+}
+
+static void emu_delay(uint32_t latency_us) {
+    if (!latency_us) {
+        return;
+    }
+
+    uint32_t start = clock_get_us();
+    while (clock_get_us() - start < latency_us);
+}
+
+static uint8_t emu_r1(sd_emu_ctx *ctx, uint8_t flags) {
+    return flags | (ctx->idle ? R1_IDLE : 0);
+}
+
+/**
+ * @brief      queue bytes to be shifted out, followed by `busy` busy bytes
+ */
+static void emu_queue(sd_emu_ctx *ctx, const uint8_t *bytes, uint32_t len,
+    uint32_t busy, emu_state next) {
+    memcpy(ctx->resp, bytes, len);
+
+    ctx->resp_len  = len;
+    ctx->resp_pos  = 0;
+    ctx->busy_left = busy;
+    ctx->state     = EMU_RESP;
+    ctx->next      = next;
+}
+
+/**
+ * @brief      queue command response, it goes out after one NCR byte
+ */
+static void emu_respond(sd_emu_ctx *ctx, const uint8_t *resp, uint32_t len, emu_state next) {
+    uint8_t buf[EMU_RESP_MAX] = { 0xff };
+
+    memcpy(buf + 1, resp, len);
+
+    emu_queue(ctx, buf, len + 1, 0, next);
+}
+
+/**
+ * @brief      start shifting out data block prepared in data buffer
+ */
+static void emu_data_start(sd_emu_ctx *ctx, uint32_t len) {
+    ctx->data_len  = len;
+    ctx->data_pos  = 0;
+    ctx->crc       = emu_crc16(ctx->data, len);
+    ctx->phase     = READ_ACCESS;
+    //! Nac is at least one byte
+    ctx->wait_left = ctx->cfg.access_bytes + 1;
+}
+
+/**
+ * @brief      load read block into data buffer
+ *
+ * @return     0 on success
+ */
+static int emu_load(sd_emu_ctx *ctx) {
+    if (ctx->blk >= ctx->blocks ||
+        ctx->cfg.disk->read(ctx->cfg.disk, ctx->blk, ctx->data)) {
+        return -1;
+    }
+
+    emu_data_start(ctx, EMU_BLOCK_SIZE);
+
+    return 0;
+}
+
+static void emu_csd(sd_emu_ctx *ctx) {
+    //! CSD v2: capacity is (C_SIZE + 1) * 512 KiB
+    uint32_t c_size = ctx->blocks / 1024;
+    c_size = c_size ? c_size - 1 : 0;
+
+    memset(ctx->data, 0, EMU_CSD_SIZE);
+
+    ctx->data[0]  = 0x40;
+    //! TRAN_SPEED 25 MHz
+    ctx->data[3]  = 0x32;
+    //! READ_BL_LEN 512
+    ctx->data[5]  = 0x59;
+    ctx->data[7]  = (c_size >> 16) & 0x3f;
+    ctx->data[8]  = (c_size >> 8) & 0xff;
+    ctx->data[9]  = c_size & 0xff;
+    ctx->data[15] = emu_crc7(ctx->data, EMU_CSD_SIZE - 1);
+
+    emu_data_start(ctx, EMU_CSD_SIZE);
+}
+
+static void emu_command(sd_emu_ctx *ctx) {
+    const uint8_t *cmd = ctx->cmd;
+    uint8_t  index = cmd[0] & CMD_INDEX_MASK;
+    uint32_t arg   = (cmd[1] << 24) | (cmd[2] << 16) | (cmd[3] << 8) | cmd[4];
+
+    uint8_t app = ctx->app_cmd;
+    ctx->app_cmd = 0;
+
+    ctx->stat.commands++;
+
+    emu_delay(ctx->cfg.cmd_latency_us);
+
+    if (cmd[5] != emu_crc7(cmd, EMU_CMD_SIZE - 1)) {
+        ctx->stat.crc_errors++;
+
+        uint8_t r1 = emu_r1(ctx, R1_CRC_ERR);
+        emu_respond(ctx, &r1, 1, EMU_CMD);
+        return;
+    }
+
+    if (index == 12) {
+        if (ctx->state == EMU_READ) {
+            //! stuff byte instead of NCR, R1, then busy
+            uint8_t resp[2] = { STUFF_BYTE, emu_r1(ctx, 0) };
+            emu_queue(ctx, resp, sizeof(resp), ctx->cfg.busy_bytes, EMU_CMD);
+            return;
+        }
+
+        uint8_t r1 = emu_r1(ctx, 0);
+        emu_respond(ctx, &r1, 1, EMU_CMD);
+        return;
+    }
+
+    if (ctx->state == EMU_READ) {
+        //! anything but CMD12 is ignored while streaming data
+        return;
+    }
+
+    if (app && index == 41) {
+        if (ctx->init_left) {
+            ctx->init_left--;
+        } else {
+            ctx->idle = 0;
+        }
+
+        uint8_t r1 = emu_r1(ctx, 0);
+        emu_respond(ctx, &r1, 1, EMU_CMD);
+        return;
+    }
+
+    switch (index) {
+        case 0: {
+            ctx->idle      = 1;
+            ctx->init_left = ctx->cfg.init_polls;
+
+            uint8_t r1 = emu_r1(ctx, 0);
+            emu_respond(ctx, &r1, 1, EMU_CMD);
+            return;
+        }
+        case 8: {
+            //! R7: voltage accepted, check pattern echoed
+            uint8_t r7[5] = { emu_r1(ctx, 0), 0x00, 0x00, (arg >> 8) & 0x0f, arg & 0xff };
+            emu_respond(ctx, r7, sizeof(r7), EMU_CMD);
+            return;
+        }
+        case 55: {
+            ctx->app_cmd = 1;
+
+            uint8_t r1 = emu_r1(ctx, 0);
+            emu_respond(ctx, &r1, 1, EMU_CMD);
+            return;
+        }
+        case 58: {
+            uint32_t ocr = ctx->idle ? OCR_BUSY : OCR_READY;
+            uint8_t  r3[5] = { emu_r1(ctx, 0), ocr >> 24, (ocr >> 16) & 0xff,
+                (ocr >> 8) & 0xff, ocr & 0xff };
+            emu_respond(ctx, r3, sizeof(r3), EMU_CMD);
+            return;
+        }
+        case 59: {
+            uint8_t r1 = emu_r1(ctx, 0);
+            emu_respond(ctx, &r1, 1, EMU_CMD);
+            return;
+        }
+        default:
+            break;
+    }
+
+    if (ctx->idle) {
+        //! card is not initialized yet
+        uint8_t r1 = emu_r1(ctx, R1_ILLEGAL_CMD);
+        emu_respond(ctx, &r1, 1, EMU_CMD);
+        return;
+    }
+
+    uint8_t r1 = 0;
+    emu_state next = EMU_CMD;
+
+    switch (index) {
+        case 9:
+            emu_csd(ctx);
+            ctx->multi = 0;
+            next = EMU_READ;
+            break;
+        case 16:
+            r1 = arg == EMU_BLOCK_SIZE ? 0 : R1_PARAM_ERR;
+            break;
+        case 17:
+        case 18:
+            ctx->blk   = arg;
+            ctx->multi = index == 18;
+            if (emu_load(ctx)) {
+                r1 = R1_ADDR_ERR;
+            } else {
+                next = EMU_READ;
+            }
+            break;
+        case 24:
+        case 25:
+            if (arg >= ctx->blocks) {
+                r1 = R1_ADDR_ERR;
+            } else {
+                ctx->blk   = arg;
+                ctx->multi = index == 25;
+                next = EMU_WRITE;
+            }
+            break;
+        default:
+            r1 = R1_ILLEGAL_CMD;
+            break;
+    }
+
+    emu_respond(ctx, &r1, 1, next);
+}
+
+static uint8_t emu_read_next(sd_emu_ctx *ctx) {
+    switch (ctx->phase) {
+        case READ_ACCESS:
+            if (ctx->wait_left) {
+                ctx->wait_left--;
+                return 0xff;
+            }
+            ctx->phase = READ_DATA;
+            return START_BLOCK_TOK;
+        case READ_STALL:
+            //! next block isn't available, host times out and stops
+            return 0xff;
+        case READ_DATA: {
+            uint8_t out = ctx->data[ctx->data_pos++];
+            if (ctx->data_pos == ctx->data_len) {
+                ctx->phase = READ_CRC_HI;
+            }
+            return out;
+        }
+        case READ_CRC_HI:
+            ctx->phase = READ_CRC_LO;
+            return ctx->crc >> 8;
+        case READ_CRC_LO: {
+            uint8_t out = ctx->crc & 0xff;
+            if (!ctx->multi) {
+                ctx->state = EMU_CMD;
+            } else {
+                ctx->blk++;
+                if (emu_load(ctx)) {
+                    ctx->phase = READ_STALL;
+                }
+            }
+            return out;
+        }
+    }
+
+    return 0xff;
+}
+
+static void emu_write_block(sd_emu_ctx *ctx) {
+    uint16_t crc = (ctx->data[EMU_BLOCK_SIZE] << 8) | ctx->data[EMU_BLOCK_SIZE + 1];
+
+    uint8_t resp = DATA_ACCEPTED;
+    if (crc != emu_crc16(ctx->data, EMU_BLOCK_SIZE)) {
+        ctx->stat.crc_errors++;
+        resp = DATA_CRC_ERR;
+    } else if (ctx->blk >= ctx->blocks ||
+        ctx->cfg.disk->write(ctx->cfg.disk, ctx->blk, ctx->data)) {
+        resp = DATA_WRITE_ERR;
+    }
+
+    ctx->blk++;
+
+    //! data response follows last CRC byte immediately, then busy
+    uint8_t token = resp | 0xe0;
+    emu_queue(ctx, &token, 1, ctx->cfg.busy_bytes,
+        ctx->multi && resp == DATA_ACCEPTED ? EMU_WRITE : EMU_CMD);
+}
+
+static uint8_t sd_emu_txrx_byte(spi_iface *iface, uint8_t in) {
+    sd_emu_ctx *ctx = (sd_emu_ctx *) iface;
+
+    if (ctx->cs) {
+        //! not selected: DO is released
+        return 0xff;
+    }
+
+    ctx->stat.bytes++;
+
+    uint8_t out = 0xff;
+
+    switch (ctx->state) {
+        case EMU_RESP:
+            out = ctx->resp[ctx->resp_pos++];
+            if (ctx->resp_pos == ctx->resp_len) {
+                ctx->state = ctx->busy_left ? EMU_BUSY : ctx->next;
+            }
+            return out;
+        case EMU_BUSY:
+            if (!--ctx->busy_left) {
+                ctx->state = ctx->next;
+            }
+            return 0x00;
+        case EMU_WRITE:
+            if (in == (ctx->multi ? START_MULTI_TOK : START_BLOCK_TOK)) {
+                ctx->data_pos = 0;
+                ctx->state    = EMU_WRITE_DATA;
+            } else if (ctx->multi && in == STOP_TRAN_TOK) {
+                //! one byte gap before busy
+                uint8_t gap = 0xff;
+                emu_queue(ctx, &gap, 1, ctx->cfg.busy_bytes, EMU_CMD);
+            }
+            return 0xff;
+        case EMU_WRITE_DATA:
+            ctx->data[ctx->data_pos++] = in;
+            if (ctx->data_pos == EMU_BLOCK_SIZE + 2) {
+                emu_write_block(ctx);
+            }
+            return 0xff;
+        case EMU_READ:
+            out = emu_read_next(ctx);
+            break;
+        case EMU_CMD:
+            break;
+    }
+
+    //! command parser runs while idle and while streaming (for CMD12)
+    if (!ctx->cmd_pos && (in & CMD_START_MASK) != CMD_START) {
+        return out;
+    }
+
+    ctx->cmd[ctx->cmd_pos++] = in;
+    if (ctx->cmd_pos == EMU_CMD_SIZE) {
+        ctx->cmd_pos = 0;
+        emu_command(ctx);
+    }
+
+    return out;
+}
+
+static void sd_emu_enable(spi_iface *iface, int enable) {
+    (void) iface;
+    (void) enable;
+}
+
+static void sd_emu_select(spi_iface *iface, int cs_value) {
+    sd_emu_ctx *ctx = (sd_emu_ctx *) iface;
+
+    ctx->cs = !!cs_value;
+}
+
+static void sd_emu_set_prescaler(spi_iface *iface, spi_prescaler prescaler) {
+    (void) iface;
+    (void) prescaler;
+}
+
+static void sd_emu_tx_byte(spi_iface *iface, uint8_t byte) {
+    sd_emu_txrx_byte(iface, byte);
+}
+
+static uint8_t sd_emu_rx_byte(spi_iface *iface) {
+    return sd_emu_txrx_byte(iface, 0xff);
+}
+
+static int sd_emu_transmit(spi_iface *iface, const uint8_t *data, uint32_t len) {
+    while (len--) {
+        sd_emu_txrx_byte(iface, *data++);
+    }
+
+    return 0;
+}
+
+static int sd_emu_transmit_receive(spi_iface *iface, const uint8_t *tx_buf,
+    uint8_t *rx_buf, uint32_t len) {
+    while (len--) {
+        *rx_buf++ = sd_emu_txrx_byte(iface, *tx_buf++);
+    }
+
+    return 0;
+}
+
+static int sd_emu_receive(spi_iface *iface, uint8_t *data, uint32_t len) {
+    while (len--) {
+        *data++ = sd_emu_txrx_byte(iface, 0xff);
+    }
+
+    return 0;
+}
+
+static void sd_emu_destroy(spi_iface *iface) {
+    free(iface);
+}
+
+spi_iface *sd_emu_init(const sd_emu_config *cfg) {
+    if (!cfg || !cfg->disk) {
+        return NULL;
+    }
+
+    disk_stat stat;
+    if (cfg->disk->get_stat(cfg->disk, &stat) || stat.block_size != EMU_BLOCK_SIZE) {
+        return NULL;
+    }
+
+    sd_emu_ctx *ctx = zmalloc(sizeof(sd_emu_ctx));
+    if (!ctx) {
+        return NULL;
+    }
+
+    memcpy(&ctx->cfg, cfg, sizeof(sd_emu_config));
+
+    ctx->blocks = stat.blocks;
+    ctx->cs     = 1;
+    ctx->idle   = 1;
+    ctx->state  = EMU_CMD;
+
+    ctx->iface.enable           = sd_emu_enable;
+    ctx->iface.select           = sd_emu_select;
+    ctx->iface.set_prescaler    = sd_emu_set_prescaler;
+    ctx->iface.tx_byte          = sd_emu_tx_byte;
+    ctx->iface.rx_byte          = sd_emu_rx_byte;
+    ctx->iface.txrx_byte        = sd_emu_txrx_byte;
+    ctx->iface.transmit         = sd_emu_transmit;
+    ctx->iface.transmit_receive = sd_emu_transmit_receive;
+    ctx->iface.receive          = sd_emu_receive;
+    ctx->iface.destroy          = sd_emu_destroy;
+
+    return &ctx->iface;
+}
+
+void sd_emu_stat_get(spi_iface *spi, sd_emu_stat *stat) {
+    sd_emu_ctx *ctx = (sd_emu_ctx *) spi;
+
+    if (ctx && stat) {
+        memcpy(stat, &ctx->stat, sizeof(sd_emu_stat));
+    }
+}
+
+#endif
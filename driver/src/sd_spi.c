@@ -2,6 +2,7 @@
 #include "target/cfg.h"
 #include "kernel/syscall.h"
 #include "platform/clock.h"
+#include "lib/crc.h"
 
 #define CMD_RECV_TRY_CNT   0x800
 #define CMD_NUM_TRY        0x80
@@ -21,6 +22,8 @@
 #define REG_SIZE           0x10
 
 #define START_BLOCK_TOK    0xfe
+#define START_MULTI_TOK    0xfc
+#define STOP_TRAN_TOK      0xfd
 #define DATA_ACCEPTED_TOK  0x05
 
 #define SD_BLOCK_SIZE 512
@@ -63,60 +66,35 @@ typedef enum sd_r1_resp_t {
     SD_R1_INVALID       = (1 << 7),
 } sd_r1_resp;
 
-static uint8_t crc7_update(uint8_t crc, uint8_t data) {
-
-    crc ^= data;
-    for (int i = 0; i < 8; i++) {
-        if (crc & 0x80) {
-            crc ^= 0x89;
-        }
-        crc <<= 1;
-    }
-
-    return crc;
-}
-
-static uint8_t crc7(const uint8_t *buf, uint32_t buf_size) {
-    uint8_t crc = 0;
-
-    while (buf_size--) {
-        crc = crc7_update(crc, *buf++);
-    }
-
-    //! last bit should be set
-    return (crc | 0x01);
+static void sd_cmd_frame(uint8_t *cmd_buf, uint8_t cmd, uint32_t arg) {
+    cmd_buf[0] = cmd | CMD_OFFSET;
+    cmd_buf[1] = (arg >> 0x18) & 0xff;
+    cmd_buf[2] = (arg >> 0x10) & 0xff;
+    cmd_buf[3] = (arg >> 0x08) & 0xff;
+    cmd_buf[4] = (arg >> 0x00) & 0xff;
+    //! end bit set
+    cmd_buf[CMD_TX_SIZE - 1] = crc7(cmd_buf, CMD_TX_SIZE - 1) | 0x01;
 }
 
-uint16_t crc16_update(uint16_t crc, uint8_t data) {
-    crc  = (uint8_t)(crc >> 8)|(crc << 8);
-    crc ^=  data;
-    crc ^= (uint8_t)(crc & 0xff) >> 4;
-    crc ^= (crc << 8) << 4;
-    crc ^= ((crc & 0xff) << 4) << 1;
-
-    return crc;
-}
-
-uint16_t crc16(const uint8_t *buf, uint32_t buf_size) {
-    uint16_t crc = 0;
-
-    while (buf_size--) {
-        crc = crc16_update(crc, *buf++);
+/**
+ * @brief      wait until card releases busy (DO held low), CS is asserted
+ *
+ * @return     0 when ready, otherwise timeout
+ */
+static int sd_wait_ready(spi_iface *spi, int32_t timeout) {
+    int now = clock_get();
+    while (!spi->rx_byte(spi)) {
+        if (clock_get() - now >= timeout) {
+            return -1;
+        }
     }
 
-    return crc;
+    return 0;
 }
 
 static uint8_t sd_cmd(spi_iface *spi, uint8_t cmd, uint32_t arg, uint8_t *res, uint32_t res_len) {
-    uint8_t cmd_buf[CMD_TX_SIZE] = {
-        cmd | CMD_OFFSET,
-        (arg >> 0x18) & 0xff,
-        (arg >> 0x10) & 0xff,
-        (arg >> 0x08) & 0xff,
-        (arg >> 0x00) & 0xff,
-        0,
-    };
-    cmd_buf[CMD_TX_SIZE - 1] = crc7(cmd_buf, CMD_TX_SIZE - 1);
+    uint8_t cmd_buf[CMD_TX_SIZE];
+    sd_cmd_frame(cmd_buf, cmd, arg);
 
     spi->select(spi, 0);
 
@@ -296,96 +274,173 @@ static int sd_init_sequence(sd_spi_ctx *ctx) {
     return 0;
 }
 
-static int sd_spi_read(disk_ifc *ifc, uint32_t blk, uint8_t *buf) {
+/**
+ * @brief      receive one data block (start token, data, CRC), CS is asserted
+ *
+ * @return     0 on success
+ */
+static int sd_read_data(spi_iface *spi, uint8_t *buf) {
+    int now = clock_get();
+    uint8_t ret = 0xff;
+    while (ret == 0xff && (clock_get() - now < READ_TIMEOUT_MSEC)) {
+        ret = spi->rx_byte(spi);
+    }
+
+    if ((clock_get() - now >= READ_TIMEOUT_MSEC) || ret != START_BLOCK_TOK) {
+        return -1;
+    }
+
+    spi->receive(spi, buf, SD_BLOCK_SIZE);
+
+    //! CRC
+    uint16_t crc = spi->rx_byte(spi);
+    crc <<= 8;
+    crc |= spi->rx_byte(spi);
+
+    return crc == crc16(buf, SD_BLOCK_SIZE) ? 0 : -2;
+}
+
+/**
+ * @brief      send one data block and wait while card is busy, CS is asserted
+ *
+ * @return     0 on success
+ */
+static int sd_write_data(spi_iface *spi, uint8_t token, const uint8_t *buf) {
+    uint16_t crc = crc16(buf, SD_BLOCK_SIZE);
+
+    spi->tx_byte(spi, token);
+    spi->transmit(spi, buf, SD_BLOCK_SIZE);
+
+    spi->tx_byte(spi, crc >> 0x08);
+    spi->tx_byte(spi, crc & 0xff);
+
+    uint8_t ret = spi->rx_byte(spi);
+    if ((ret & 0x1f) != DATA_ACCEPTED_TOK) {
+        return -1;
+    }
+
+    return sd_wait_ready(spi, WRITE_TIMEOUT_MSEC) ? -2 : 0;
+}
+
+/**
+ * @brief      terminate multiple block read (CMD12)
+ *
+ * @return     0 on success
+ */
+static int sd_stop_transmission(spi_iface *spi) {
+    uint8_t cmd_buf[CMD_TX_SIZE];
+    sd_cmd_frame(cmd_buf, 0x0c, 0x00);
+
+    spi->transmit(spi, cmd_buf, CMD_TX_SIZE);
+
+    //! stuff byte
+    spi->rx_byte(spi);
+
+    uint32_t try_cnt = CMD_RECV_TRY_CNT;
+    uint8_t ret = SD_R1_INVALID;
+    while (--try_cnt && FLAG_GET(ret, SD_R1_INVALID)) {
+        ret = spi->rx_byte(spi);
+    }
+
+    if (!try_cnt || ret) {
+        return -1;
+    }
+
+    return sd_wait_ready(spi, READ_TIMEOUT_MSEC) ? -2 : 0;
+}
+
+static int sd_spi_read_blocks(disk_ifc *ifc, uint32_t blk, uint32_t count, uint8_t *buf) {
     sd_spi_ctx *ctx = (sd_spi_ctx *) ifc;
-    if (!ctx) {
+    if (!ctx || !buf) {
         return -1;
     }
 
+    if (!count) {
+        return 0;
+    }
+
     if (ctx->stat.type != SD_SDHC) {
         //! byte addr
         blk <<= 9;
     }
 
-    uint8_t ret = sd_cmd(ctx->spi, 0x11, blk, NULL, 0);
+    //! READ_SINGLE_BLOCK or READ_MULTIPLE_BLOCK
+    uint8_t ret = sd_cmd(ctx->spi, count == 1 ? 0x11 : 0x12, blk, NULL, 0);
     if (ret) {
         return -2;
     }
 
     ctx->spi->select(ctx->spi, 0);
 
-    int now = clock_get();
-    ret = 0xff;
-    while (ret == 0xff && (clock_get() - now < READ_TIMEOUT_MSEC)) {
-        ret = ctx->spi->rx_byte(ctx->spi);
+    int err = 0;
+    for (uint32_t i = 0; i < count && !err; ++i) {
+        err = sd_read_data(ctx->spi, buf + i * SD_BLOCK_SIZE);
     }
 
-    if ((clock_get() - now >= READ_TIMEOUT_MSEC) || ret != START_BLOCK_TOK) {
-        ctx->spi->rx_byte(ctx->spi);
-        ctx->spi->select(ctx->spi, 1);
-        return -3;
+    if (count > 1 && sd_stop_transmission(ctx->spi)) {
+        err = err ? err : -4;
     }
 
-    ctx->spi->receive(ctx->spi, buf, SD_BLOCK_SIZE);
-
-    //! CRC
-    uint16_t crc = ctx->spi->rx_byte(ctx->spi);
-    crc <<= 8;
-    crc |= ctx->spi->rx_byte(ctx->spi);
-
     ctx->spi->rx_byte(ctx->spi);
 
     ctx->spi->select(ctx->spi, 1);
 
-    return !(crc == crc16(buf, SD_BLOCK_SIZE));
+    return err ? -3 : 0;
 }
 
-static int sd_spi_write(disk_ifc *ifc, uint32_t blk, const uint8_t *buf) {
+static int sd_spi_write_blocks(disk_ifc *ifc, uint32_t blk, uint32_t count, const uint8_t *buf) {
     sd_spi_ctx *ctx = (sd_spi_ctx *) ifc;
-    if (!ctx) {
+    if (!ctx || !buf) {
         return -1;
     }
 
+    if (!count) {
+        return 0;
+    }
+
     if (ctx->stat.type != SD_SDHC) {
         //! byte addr
         blk <<= 9;
     }
 
-    uint16_t crc = crc16(buf, SD_BLOCK_SIZE);
-
-    uint8_t ret = sd_cmd(ctx->spi, 0x18, blk, NULL, 0);
+    //! WRITE_BLOCK or WRITE_MULTIPLE_BLOCK
+    uint8_t ret = sd_cmd(ctx->spi, count == 1 ? 0x18 : 0x19, blk, NULL, 0);
     if (ret) {
         return -2;
     }
 
     ctx->spi->select(ctx->spi, 0);
 
-    ctx->spi->tx_byte(ctx->spi, START_BLOCK_TOK);
-    ctx->spi->transmit(ctx->spi, buf, SD_BLOCK_SIZE);
-
-    ctx->spi->tx_byte(ctx->spi, crc >> 0x08);
-    ctx->spi->tx_byte(ctx->spi, crc && 0xff);
+    int err = 0;
+    if (count == 1) {
+        err = sd_write_data(ctx->spi, START_BLOCK_TOK, buf);
+    } else {
+        for (uint32_t i = 0; i < count && !err; ++i) {
+            err = sd_write_data(ctx->spi, START_MULTI_TOK, buf + i * SD_BLOCK_SIZE);
+        }
 
-    ret = ctx->spi->rx_byte(ctx->spi);
-    ret &= 0x1f;
-    if (ret != DATA_ACCEPTED_TOK) {
+        //! stop is sent on error too, card leaves receive-data state
+        ctx->spi->tx_byte(ctx->spi, STOP_TRAN_TOK);
         ctx->spi->rx_byte(ctx->spi);
-        ctx->spi->select(ctx->spi, 1);
-
-        return -3;
-    }
 
-    int now = clock_get();
-    ret = 0;
-    while (ret == 0 && (clock_get() - now < WRITE_TIMEOUT_MSEC)) {
-        ret = ctx->spi->rx_byte(ctx->spi);
+        if (sd_wait_ready(ctx->spi, WRITE_TIMEOUT_MSEC)) {
+            err = err ? err : -4;
+        }
     }
 
     ctx->spi->rx_byte(ctx->spi);
 
     ctx->spi->select(ctx->spi, 1);
 
-    return 0;
+    return err ? -3 : 0;
+}
+
+static int sd_spi_read(disk_ifc *ifc, uint32_t blk, uint8_t *buf) {
+    return sd_spi_read_blocks(ifc, blk, 1, buf);
+}
+
+static int sd_spi_write(disk_ifc *ifc, uint32_t blk, const uint8_t *buf) {
+    return sd_spi_write_blocks(ifc, blk, 1, buf);
 }
 
 static int sd_spi_get_stat(disk_ifc *ifc, disk_stat *stat) {
@@ -396,6 +451,7 @@ static int sd_spi_get_stat(disk_ifc *ifc, disk_stat *stat) {
 
     stat->size_mb = ctx->stat.size_mb;
     stat->block_size = SD_BLOCK_SIZE;
+    stat->blocks = ctx->stat.size_mb * (0x100000 / SD_BLOCK_SIZE);
 
     return 0;
 }
@@ -411,14 +467,7 @@ static void sd_spi_destroy(disk_ifc *ifc) {
     free(ctx);
 }
 
-disk_ifc *sd_spi_init(const spi_config *cfg) {
-    if (!cfg) {
-        return NULL;
-    }
-
-    spi_init(SD_SPI, cfg);
-
-    spi_iface *spi = spi_iface_get(SD_SPI);
+disk_ifc *sd_spi_attach(spi_iface *spi) {
     if (!spi) {
         return NULL;
     }
@@ -432,10 +481,12 @@ disk_ifc *sd_spi_init(const spi_config *cfg) {
 
     ctx->spi          = spi;
 
-    ctx->ifc.read     = sd_spi_read;
-    ctx->ifc.write    = sd_spi_write;
-    ctx->ifc.get_stat = sd_spi_get_stat;
-    ctx->ifc.destroy  = sd_spi_destroy;
+    ctx->ifc.read         = sd_spi_read;
+    ctx->ifc.write        = sd_spi_write;
+    ctx->ifc.read_blocks  = sd_spi_read_blocks;
+    ctx->ifc.write_blocks = sd_spi_write_blocks;
+    ctx->ifc.get_stat     = sd_spi_get_stat;
+    ctx->ifc.destroy      = sd_spi_destroy;
 
     spi->enable(spi, 1);
 
@@ -447,3 +498,13 @@ disk_ifc *sd_spi_init(const spi_config *cfg) {
 
     return &ctx->ifc;
 }
+
+disk_ifc *sd_spi_init(const spi_config *cfg) {
+    if (!cfg) {
+        return NULL;
+    }
+
+    spi_init(SD_SPI, cfg);
+
+    return sd_spi_attach(spi_iface_get(SD_SPI));
+}
@@ -3,7 +3,16 @@
 
 #include "common/def.h"
 #include "common/common.h"
-
+#include "lib/ring.h"
+
+/**
+ * @brief      create pipe over caller provided storage
+ *
+ * NOTE: pipe capacity is the largest power of two not greater than
+ *       `buffer_size`, the rest of the storage is unused
+ *
+ * @return     pipe, NULL on failure
+ */
 const
 void *pipe_create(const void *source, const void *dest, uint8_t *buffer, uint32_t buffer_size);
 
@@ -11,6 +20,21 @@ int pipe_write(const void *pipe, const void *source, char *buffer, uint32_t buff
 
 int pipe_read(const void *pipe, const void *source, char *buffer, uint32_t buffer_size);
 
+/**
+ * @brief      write segments to pipe as a whole
+ *
+ * @return     number of bytes written, otherwise negative (-4 if pipe has
+ *             no room for all segments)
+ */
+int pipe_writev(const void *pipe, const void *source, const io_vec *vec, uint32_t count);
+
+/**
+ * @brief      read pipe data into segments
+ *
+ * @return     number of bytes read, otherwise negative
+ */
+int pipe_readv(const void *pipe, const void *source, const io_vec *vec, uint32_t count);
+
 int pipe_close(const void *pipe, const void *source);
 
 const
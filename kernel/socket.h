@@ -3,10 +3,63 @@
 
 #include "common/def.h"
 #include "common/common.h"
+#include "lib/ring.h"
 
 #define SOCKET_MAX_NAME_LENGTH 32
 
-int socket_create(const void *owner, uint8_t port);
+#define SOCKET_PORT_MAX        256
+
+/**
+ * connection framing
+ */
+typedef enum socket_mode_t {
+    /**
+     * byte stream, no message boundaries
+     */
+    SOCKET_STREAM = 0x00,
+    /**
+     * every write is queued as one length prefixed message (or not at
+     * all) and every read returns exactly one message
+     */
+    SOCKET_DGRAM  = 0x01,
+} socket_mode;
+
+/**
+ * per-port statistics
+ */
+typedef struct socket_stat_t {
+    /**
+     * connections accepted/declined by socket owner
+     */
+    uint32_t              accepted;
+    uint32_t              declined;
+    /**
+     * bytes written by clients/by socket owner
+     */
+    uint32_t              bytes_in;
+    uint32_t              bytes_out;
+    /**
+     * max bytes queued to socket owner/to clients
+     */
+    uint32_t              rx_high_water;
+    uint32_t              tx_high_water;
+    /**
+     * pending connections now/at most
+     */
+    uint32_t              backlog;
+    uint32_t              backlog_high_water;
+} socket_stat;
+
+/**
+ * @brief      create socket
+ *
+ * @param[in]  owner  socket owner
+ * @param[in]  port   socket port
+ * @param[in]  mode   connection framing (socket_mode)
+ *
+ * @return     0 in case of success, otherwise negative
+ */
+int socket_create(const void *owner, uint8_t port, uint8_t mode);
 
 int socket_connect(uint8_t port, const void *owner, const void **reply_ptr, uint32_t buffer_size);
 
@@ -23,13 +76,94 @@ int socket_write(const void *dest, const void *owner, char * buffer, uint32_t bu
 
 int socket_read(const void *dest, const void *owner, char * buffer, uint32_t buf_size);
 
+/**
+ * @brief      write segments to connection
+ *
+ * In datagram mode segments form one message.
+ *
+ * @return     number of bytes written, otherwise negative
+ */
+int socket_writev(const void *dest, const void *owner, const io_vec *vec, uint32_t count);
+
+/**
+ * @brief      read connection data into segments
+ *
+ * In datagram mode one message is scattered over segments.
+ *
+ * @return     number of bytes read, otherwise negative
+ */
+int socket_readv(const void *dest, const void *owner, const io_vec *vec, uint32_t count);
+
+/**
+ * @brief      loan contiguous region of connection ring to the writer
+ *
+ * @param[in]  dest   connection descriptor
+ * @param[in]  owner  requester
+ * @param[in]  size   desired region size
+ * @param      ptr    region start (output)
+ *
+ * @return     region size (not less than size), otherwise negative
+ *
+ * NOTE: in datagram mode region is a single message payload, commit
+ *       publishes it as one message
+ */
+int socket_write_reserve(const void *dest, const void *owner, uint32_t size, void **ptr);
+
+/**
+ * @brief      publish bytes filled in the loaned region
+ *
+ * @return     number of published bytes, otherwise negative
+ */
+int socket_write_commit(const void *dest, const void *owner, uint32_t size);
+
+/**
+ * @brief      loan contiguous region of received data to the reader
+ *
+ * @param[in]  dest   connection descriptor
+ * @param[in]  owner  requester
+ * @param      ptr    region start (output)
+ *
+ * @return     region size (0 if no data), otherwise negative
+ *
+ * NOTE: in datagram mode region is a single message payload, it fails if
+ *       message is split by the ring wrap point (plain read still works)
+ */
+int socket_read_peek(const void *dest, const void *owner, const void **ptr);
+
+/**
+ * @brief      release bytes consumed from the loaned region
+ *
+ * NOTE: in datagram mode whole message is released
+ *
+ * @return     number of released bytes, otherwise negative
+ */
+int socket_read_release(const void *dest, const void *owner, uint32_t size);
+
 const
 void *socket_get_peer(const void *dest, const void *source);
 
+/**
+ * @brief      close socket (owner only) or connection
+ *
+ * Connection is closed by either side, or by any thread once its client
+ * has exited.
+ *
+ * @return     0 in case of success, otherwise negative
+ */
 int socket_close(const void *dest, const void *source);
 
 int is_sock(const void * sock);
 
+/**
+ * @brief      get socket statistics
+ *
+ * @param[in]  port  socket port
+ * @param      stat  statistics (output)
+ *
+ * @return     0 in case of success, otherwise negative (no socket on port)
+ */
+int socket_stat_get(uint8_t port, socket_stat *stat);
+
 int is_sock_conn(const void * conn);
 
 #endif
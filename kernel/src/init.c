@@ -2,6 +2,7 @@
 #include "arch/svc.h"
 #include "arch/systick.h"
 #include "platform/clock.h"
+#include "platform/handler.h"
 #include "kernel/init.h"
 #include "kernel/memory.h"
 #include "kernel/thread.h"
@@ -28,14 +29,18 @@ int init_threading(void) {
 
 void init_subsystems(void) {
     systick_init(CLOCK_FREQ);
+    cycle_counter_init();
     clock_init();
     heap_init();
     gpio_init();
+    handler_init();
     terminal_init();
 
     int ret = init_threading();
     if (ret) {
         LOG_ERR("Failed to init threading");
+        //! log thread will never run
+        log_drain();
     }
 
     while (1);
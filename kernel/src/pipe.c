@@ -1,23 +1,14 @@
 #include "kernel/pipe.h"
 #include "kernel/memory.h"
 #include "lib/list.h"
+#include "lib/ring.h"
 #include "common/log.h"
 
-typedef struct pipe_buffer_t {
-    uint32_t              buffer_size;
-
-    uint8_t              *wr_ptr;
-    uint8_t              *rd_ptr;
-    uint32_t              busy_count;
-
-    uint8_t              *buffer;
-} pipe_buffer;
-
 typedef struct pipe_ctx_t {
     const void           *source;
     const void           *dest;
 
-    pipe_buffer           buf_ctx;
+    ring_buffer           ring;
 } pipe_ctx;
 
 static
@@ -77,11 +68,8 @@ void *pipe_create(const void *source, const void *dest, uint8_t *buffer, uint32_
 
     memset(ctx, 0, sizeof(pipe_ctx));
 
-    ctx->buf_ctx.buffer_size  = buffer_size;
-
-    ctx->buf_ctx.buffer       = buffer;
-    ctx->buf_ctx.wr_ptr       = buffer;
-    ctx->buf_ctx.rd_ptr       = buffer;
+    //! caller owns the storage: use the largest power of two fitting into it
+    ring_init(&ctx->ring, buffer, ring_size_round_down(buffer_size));
 
     ctx->source               = source;
     ctx->dest                 = dest;
@@ -95,11 +83,21 @@ void *pipe_create(const void *source, const void *dest, uint8_t *buffer, uint32_
 }
 
 int pipe_write(const void *pipe, const void *source, char *buffer, uint32_t buffer_size) {
+    io_vec vec = {
+        .data = buffer,
+        .size = buffer_size,
+    };
+
+    return pipe_writev(pipe, source, &vec, 1);
+}
+
+int pipe_writev(const void *pipe, const void *source, const io_vec *vec, uint32_t count) {
     if (!pipe_list && pipes_init()) {
         return -1;
     }
 
-    if (!buffer_size) {
+    int buffer_size = io_vec_size(vec, count);
+    if (buffer_size <= 0) {
         return -1;
     }
 
@@ -116,27 +114,23 @@ int pipe_write(const void *pipe, const void *source, char *buffer, uint32_t buff
         return -3;
     }
 
-    pipe_buffer *buf = &sock_ctx->buf_ctx;
-
-    if (buf->busy_count + buffer_size > buf->buffer_size) {
+    if (ring_free(&sock_ctx->ring) < (uint32_t) buffer_size) {
         return -4;
     }
 
-    uint32_t count = 0;
-
-    while (count < buffer_size) {
-        *buf->wr_ptr++ = buffer[count++];
-        buf->busy_count++;
+    return ring_writev(&sock_ctx->ring, vec, count);
+}
 
-        if (buf->wr_ptr >= (buf->buffer + buf->buffer_size)) {
-            buf->wr_ptr = buf->buffer;
-        }
-    }
+int pipe_read(const void *pipe, const void *source, char *buffer, uint32_t buffer_size) {
+    io_vec vec = {
+        .data = buffer,
+        .size = buffer_size,
+    };
 
-    return count;
+    return pipe_readv(pipe, source, &vec, 1);
 }
 
-int pipe_read(const void *pipe, const void *source, char *buffer, uint32_t buffer_size) {
+int pipe_readv(const void *pipe, const void *source, const io_vec *vec, uint32_t count) {
     if (!pipe_list && pipes_init()) {
         return -1;
     }
@@ -154,24 +148,12 @@ int pipe_read(const void *pipe, const void *source, char *buffer, uint32_t buffe
         return -3;
     }
 
-    pipe_buffer *buf = &sock_ctx->buf_ctx;
-
-    uint32_t count = 0;
-
-    while (count < buffer_size) {
-        if (!buf->busy_count) {
-            break;
-        }
-
-        buffer[count++] = *buf->rd_ptr++;
-        buf->busy_count--;
-
-        if (buf->rd_ptr >= (buf->buffer + buf->buffer_size)) {
-            buf->rd_ptr = buf->buffer;
-        }
+    int len = io_vec_size(vec, count);
+    if (len < 0) {
+        return -4;
     }
 
-    return count;
+    return ring_readv(&sock_ctx->ring, vec, count, len);
 }
 
 int pipe_close(const void *pipe, const void *source) {
@@ -210,7 +192,7 @@ void *pipe_get_ready(const void *source) {
     while (node) {
         sock_ctx = node->ptr;
 
-        if (sock_ctx->dest == source && sock_ctx->buf_ctx.busy_count > 0) {
+        if (sock_ctx->dest == source && ring_used(&sock_ctx->ring)) {
             return sock_ctx;
         }
 
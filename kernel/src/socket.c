@@ -1,7 +1,9 @@
 #include "kernel/socket.h"
 #include "kernel/pipe.h"
+#include "kernel/thread.h"
 #include "kernel/memory.h"
 #include "lib/list.h"
+#include "lib/ring.h"
 #include "lib/string.h"
 #include "common/log.h"
 
@@ -9,27 +11,30 @@
 
 #define CONNECTION_ESTABLISHED(conn_context) ((conn_context)->client_buffer.buffer)
 
-typedef struct socket_io_buffer_t {
-    uint8_t              *wr_ptr;
-    uint8_t              *rd_ptr;
+#define SOCKET_IS_DGRAM(sock_context) ((sock_context)->mode == SOCKET_DGRAM)
 
-    uint8_t              *buffer;
+//! datagram is prefixed with its length
+#define DGRAM_HDR_SIZE sizeof(uint16_t)
 
-    uint32_t              buffer_size;
-    uint32_t              busy_count;
-} socket_io_buffer;
+#define SOCKET_PORT_BITMAP_SIZE (SOCKET_PORT_MAX / 32)
 
 typedef struct socket_ctx_t {
     uint8_t               port;
 
+    uint8_t               mode;
+
     list_ifc             *connections;
 
     const void           *owner;
+
+    uint32_t              backlog;
+
+    socket_stat           stat;
 } socket_ctx;
 
 typedef struct socket_connection_t {
-    socket_io_buffer      owner_buffer;
-    socket_io_buffer      client_buffer;
+    ring_buffer           owner_buffer;
+    ring_buffer           client_buffer;
 
     const void          **reply_ptr;
 
@@ -38,50 +43,102 @@ typedef struct socket_connection_t {
     const void           *client;
 } socket_connection;
 
+/**
+ * port table: bitmap of used ports plus dense array of sockets ordered
+ * by port, socket index is the number of used ports below its own
+ */
 static
-list_ifc *socket_list = NULL;
+uint32_t     port_bitmap[SOCKET_PORT_BITMAP_SIZE] = {0};
 
 static
-int sockets_init(void) {
-    if (socket_list) {
-        return 0;
-    }
+socket_ctx **port_sockets = NULL;
 
-    socket_list = list_create();
-    if (!socket_list) {
-        return -1;
+static
+uint32_t     port_count   = 0;
+
+static inline
+uint32_t popcount(uint32_t value) {
+    value = value - ((value >> 1) & 0x55555555);
+    value = (value & 0x33333333) + ((value >> 2) & 0x33333333);
+    value = (value + (value >> 4)) & 0x0f0f0f0f;
+
+    return (value * 0x01010101) >> 24;
+}
+
+static inline
+int port_used(uint8_t port) {
+    return port_bitmap[port >> 5] & BIT(port & 0x1f);
+}
+
+static inline
+uint32_t port_rank(uint8_t port) {
+    uint32_t rank = 0;
+
+    for (uint32_t i = 0; i < (uint32_t) (port >> 5); i++) {
+        rank += popcount(port_bitmap[i]);
     }
 
-    return 0;
+    return rank + popcount(port_bitmap[port >> 5] & (BIT(port & 0x1f) - 1));
 }
 
 static inline
-void *sock_find_port(uint8_t port, int find_node) {
-    const list_node *node = socket_list->get_front(socket_list);
+socket_ctx *sock_find_port(uint8_t port) {
+    if (!port_used(port)) {
+        return NULL;
+    }
 
-    socket_ctx *sock_ctx = NULL;
+    return port_sockets[port_rank(port)];
+}
 
-    while (node) {
-        sock_ctx = node->ptr;
+static
+int sock_port_insert(socket_ctx *ctx) {
+    if (port_used(ctx->port)) {
+        return -1;
+    }
 
-        if (sock_ctx->port == port) {
-            return (find_node ? ((void*)node) : ((void*) sock_ctx));
-        }
+    socket_ctx **table = cell_alloc((port_count + 1) * sizeof(socket_ctx *));
+    if (!table) {
+        return -2;
+    }
 
-        node = node->nxt;
+    uint32_t rank = port_rank(ctx->port);
+
+    memcpy(table, port_sockets, rank * sizeof(socket_ctx *));
+    table[rank] = ctx;
+    memcpy(table + rank + 1, port_sockets + rank, (port_count - rank) * sizeof(socket_ctx *));
+
+    cell_free(port_sockets);
+
+    port_sockets = table;
+    port_count++;
+
+    port_bitmap[ctx->port >> 5] |= BIT(ctx->port & 0x1f);
+
+    return 0;
+}
+
+static
+void sock_port_remove(socket_ctx *ctx) {
+    if (!port_used(ctx->port)) {
+        return;
     }
 
-    return NULL;
+    uint32_t rank = port_rank(ctx->port);
+
+    //! shrinking in place, table is reallocated on next insertion
+    for (uint32_t i = rank; i + 1 < port_count; i++) {
+        port_sockets[i] = port_sockets[i + 1];
+    }
+
+    port_count--;
+
+    port_bitmap[ctx->port >> 5] &= ~BIT(ctx->port & 0x1f);
 }
 
 static inline
 void *sock_find_conn(const void *dest, int find_node) {
-    const list_node *sock_node = socket_list->get_front(socket_list);
-
-    socket_ctx *sock_ctx = NULL;
-
-    while (sock_node) {
-        sock_ctx = sock_node->ptr;
+    for (uint32_t i = 0; i < port_count; i++) {
+        socket_ctx *sock_ctx = port_sockets[i];
 
         const list_node *conn_node =
             sock_ctx->connections->get_front(sock_ctx->connections);
@@ -97,18 +154,44 @@ void *sock_find_conn(const void *dest, int find_node) {
 
             conn_node = conn_node->nxt;
         }
-
-        sock_node = sock_node->nxt;
     }
 
     return NULL;
 }
 
+/**
+ * @brief      allocate connection ring (size is rounded up to a power of two)
+ */
+static
+int sock_ring_alloc(const socket_ctx *ctx, ring_buffer *ring, uint32_t buffer_size) {
+    if (!buffer_size) {
+        buffer_size = DEFAULT_BUFFER_SIZE;
+    }
+
+    //! requested size is a payload size, leave room for the message header
+    if (SOCKET_IS_DGRAM(ctx)) {
+        buffer_size += DGRAM_HDR_SIZE;
+    }
+
+    buffer_size = ring_size_round_up(buffer_size);
+    //! cell_alloc takes a 16-bit size: larger requests would be truncated
+    if (!buffer_size || buffer_size > UINT16_MAX) {
+        return -1;
+    }
+
+    uint8_t *buf = cell_alloc(buffer_size);
+    if (!buf) {
+        return -2;
+    }
+
+    ring_init(ring, buf, buffer_size);
+
+    return 0;
+}
 
 static
 socket_connection *socket_init_connection(socket_ctx *ctx, const void *client, const void **reply_ptr,
     uint32_t buffer_size) {
-    uint8_t           *buf  = NULL;
     socket_connection *conn = cell_alloc(sizeof(socket_connection));
     if (!conn) {
         goto error;
@@ -116,20 +199,10 @@ socket_connection *socket_init_connection(socket_ctx *ctx, const void *client, c
 
     memset(conn, 0, sizeof(socket_connection));
 
-    if (!buffer_size) {
-        buffer_size = DEFAULT_BUFFER_SIZE;
-    }
-
-    buf = cell_alloc(buffer_size);
-    if (!buf) {
+    if (sock_ring_alloc(ctx, &conn->owner_buffer, buffer_size)) {
         goto error;
     }
 
-    conn->owner_buffer.rd_ptr      = buf;
-    conn->owner_buffer.wr_ptr      = buf;
-    conn->owner_buffer.buffer      = buf;
-    conn->owner_buffer.buffer_size = buffer_size;
-
     if (!ctx->connections->insert_after(ctx->connections, NULL, conn)) {
         goto error;
     }
@@ -143,11 +216,11 @@ socket_connection *socket_init_connection(socket_ctx *ctx, const void *client, c
 
     error:
 
-    if (buf) {
-        cell_free(buf);
-    }
-
     if (conn) {
+        if (conn->owner_buffer.buffer) {
+            cell_free(conn->owner_buffer.buffer);
+        }
+
         cell_free(conn);
     }
 
@@ -167,8 +240,8 @@ void sock_conn_dstor(void *ptr) {
     }
 }
 
-int socket_create(const void *owner, uint8_t port) {
-    if (sockets_init()) {
+int socket_create(const void *owner, uint8_t port, uint8_t mode) {
+    if (mode != SOCKET_STREAM && mode != SOCKET_DGRAM) {
         return -1;
     }
 
@@ -186,9 +259,11 @@ int socket_create(const void *owner, uint8_t port) {
 
     ctx->port  = port;
 
+    ctx->mode  = mode;
+
     ctx->owner = owner;
 
-    if (!socket_list->insert_after(socket_list, NULL, ctx)) {
+    if (sock_port_insert(ctx)) {
         goto error;
     }
 
@@ -208,11 +283,7 @@ int socket_create(const void *owner, uint8_t port) {
 }
 
 int socket_connect(uint8_t port, const void *client, const void **reply_ptr, uint32_t buffer_size) {
-    if (sockets_init()) {
-        return -1;
-    }
-
-    socket_ctx *ctx = sock_find_port(port, 0);
+    socket_ctx *ctx = sock_find_port(port);
     if (!ctx) {
         return -2;
     }
@@ -222,16 +293,17 @@ int socket_connect(uint8_t port, const void *client, const void **reply_ptr, uin
         return -3;
     }
 
+    ctx->backlog++;
+    if (ctx->backlog > ctx->stat.backlog_high_water) {
+        ctx->stat.backlog_high_water = ctx->backlog;
+    }
+
     return 0;
 }
 
 const
 void *socket_listen(uint8_t port, const void *owner) {
-    if (sockets_init()) {
-        return NULL;
-    }
-
-    socket_ctx *ctx = sock_find_port(port, 0);
+    socket_ctx *ctx = sock_find_port(port);
     if (!ctx) {
         return NULL;
     }
@@ -254,11 +326,7 @@ void *socket_listen(uint8_t port, const void *owner) {
 
 const
 void *socket_reply(uint8_t port, const void *owner, const void *client, uint32_t buffer_size, int accept) {
-    if (sockets_init()) {
-        return NULL;
-    }
-
-    socket_ctx *ctx = sock_find_port(port, 0);
+    socket_ctx *ctx = sock_find_port(port);
     if (!ctx) {
         return NULL;
     }
@@ -277,24 +345,23 @@ void *socket_reply(uint8_t port, const void *owner, const void *client, uint32_t
         if (!CONNECTION_ESTABLISHED(conn)) {
              if (conn->client == client) {
                 if (accept) {
-                    if (!buffer_size) {
-                        buffer_size = DEFAULT_BUFFER_SIZE;
-                    }
-                    uint8_t *buf = cell_alloc(buffer_size);
-                    if (!buf) {
+                    if (sock_ring_alloc(ctx, &conn->client_buffer, buffer_size)) {
                         return NULL;
                     }
-                    conn->client_buffer.rd_ptr      = buf;
-                    conn->client_buffer.wr_ptr      = buf;
-                    conn->client_buffer.buffer      = buf;
-                    conn->client_buffer.buffer_size = buffer_size;
 
                     *conn->reply_ptr = conn;
 
+                    ctx->backlog--;
+                    ctx->stat.accepted++;
+
                     return conn;
                 } else {
                     //! declined
                     *conn->reply_ptr = NULL;
+
+                    ctx->backlog--;
+                    ctx->stat.declined++;
+
                     ctx->connections->delete(ctx->connections, node, sock_conn_dstor);
                 }
 
@@ -310,11 +377,7 @@ void *socket_reply(uint8_t port, const void *owner, const void *client, uint32_t
 
 const
 void *socket_select(uint8_t port, const void *owner) {
-    if (sockets_init()) {
-        return NULL;
-    }
-
-    socket_ctx *ctx = sock_find_port(port, 0);
+    socket_ctx *ctx = sock_find_port(port);
     if (!ctx) {
         return NULL;
     }
@@ -331,7 +394,7 @@ void *socket_select(uint8_t port, const void *owner) {
 
         //! accepted connection
         if (CONNECTION_ESTABLISHED(conn)) {
-            if (conn->owner_buffer.busy_count > 0) {
+            if (ring_used(&conn->owner_buffer)) {
                 return conn;
             }
         }
@@ -342,11 +405,19 @@ void *socket_select(uint8_t port, const void *owner) {
     return NULL;
 }
 
-int socket_write(const void * dest, const void *owner, char *buffer, uint32_t buffer_size) {
-    if (sockets_init()) {
-        return -1;
-    }
-
+/**
+ * @brief      get connection ring for given direction
+ *
+ * @param[in]  dest   connection descriptor
+ * @param[in]  owner  requester
+ * @param[in]  tx     direction flag (write/read)
+ * @param      ring   ring (output)
+ *
+ * @return     0 in case of success, otherwise negative
+ */
+static
+int sock_conn_ring(const void *dest, const void *owner, int tx, ring_buffer **ring,
+    socket_connection **conn_out) {
     socket_connection *conn = sock_find_conn(dest, 0);
     if (!conn) {
         return -2;
@@ -356,98 +427,300 @@ int socket_write(const void * dest, const void *owner, char *buffer, uint32_t bu
         return -3;
     }
 
-    socket_ctx *sock_ctx = conn->sock_ref;
+    if (conn->client == owner) {
+        *ring = tx ? &conn->owner_buffer : &conn->client_buffer;
+    } else if (conn->sock_ref->owner == owner) {
+        *ring = tx ? &conn->client_buffer : &conn->owner_buffer;
+    } else {
+        return -4;
+    }
 
-    socket_io_buffer *buf_ctx = NULL;
+    if (conn_out) {
+        *conn_out = conn;
+    }
+
+    return 0;
+}
 
-    uint8_t          *buf     = NULL;
+/**
+ * @brief      account data written to connection ring
+ */
+static inline
+void sock_stat_update(socket_connection *conn, const void *owner, ring_buffer *ring, uint32_t size) {
+    socket_stat *stat = &conn->sock_ref->stat;
+    uint32_t     used = ring_used(ring);
 
     if (conn->client == owner) {
-        buf_ctx = (&conn->owner_buffer);
+        stat->bytes_in += size;
+        if (used > stat->rx_high_water) {
+            stat->rx_high_water = used;
+        }
+    } else {
+        stat->bytes_out += size;
+        if (used > stat->tx_high_water) {
+            stat->tx_high_water = used;
+        }
+    }
+}
 
-        buf = buf_ctx->buffer;
-    } else if (sock_ctx->owner == owner) {
-        buf_ctx = (&conn->client_buffer);
+/**
+ * @brief      get length of the datagram at ring tail
+ *
+ * @return     payload length, -1 if ring is empty
+ */
+static
+int sock_dgram_len(const ring_buffer *ring) {
+    if (ring_used(ring) < DGRAM_HDR_SIZE) {
+        return -1;
+    }
 
-        buf = buf_ctx->buffer;
-    } else {
-        return -4;
+    //! header may be split by the wrap point
+    uint32_t tail = ring->tail;
+
+    return ring->buffer[tail & ring->mask] |
+        (ring->buffer[(tail + 1) & ring->mask] << 8);
+}
+
+/**
+ * @brief      put whole datagram into ring
+ *
+ * @return     payload length, 0 if ring has no room yet, otherwise negative
+ */
+static
+int sock_dgram_writev(ring_buffer *ring, const io_vec *vec, uint32_t count) {
+    int buffer_size = io_vec_size(vec, count);
+
+    if (buffer_size < 0 || buffer_size + DGRAM_HDR_SIZE > ring_size(ring)) {
+        return -5;
     }
 
-    if (buf_ctx->busy_count + buffer_size > buf_ctx->buffer_size) {
-        buffer_size = buf_ctx->buffer_size - buf_ctx->busy_count;
+    if (buffer_size + DGRAM_HDR_SIZE > ring_free(ring)) {
+        return 0;
     }
 
-    uint32_t count = 0;
+    uint8_t hdr[DGRAM_HDR_SIZE] = {buffer_size & 0xff, buffer_size >> 8};
 
-    while (count < buffer_size) {
-        *buf_ctx->wr_ptr++ = buffer[count++];
-        buf_ctx->busy_count++;
+    ring_write(ring, hdr, DGRAM_HDR_SIZE);
 
-        if (buf_ctx->wr_ptr >= (buf + buf_ctx->buffer_size)) {
-            buf_ctx->wr_ptr = buf;
-        }
+    return ring_writev(ring, vec, count);
+}
+
+/**
+ * @brief      take whole datagram from ring, excess payload is dropped
+ *
+ * @return     number of bytes copied, 0 if no datagram pending
+ */
+static
+int sock_dgram_readv(ring_buffer *ring, const io_vec *vec, uint32_t count) {
+    int len = sock_dgram_len(ring);
+    if (len < 0) {
+        return 0;
     }
 
-    return count;
+    ring_commit_read(ring, DGRAM_HDR_SIZE);
+
+    uint32_t copy = ring_readv(ring, vec, count, len);
+
+    ring_commit_read(ring, len - copy);
+
+    return copy;
+}
+
+int socket_write(const void * dest, const void *owner, char *buffer, uint32_t buffer_size) {
+    io_vec vec = {
+        .data = buffer,
+        .size = buffer_size,
+    };
+
+    return socket_writev(dest, owner, &vec, 1);
 }
 
 int socket_read(const void * dest, const void *owner, char *buffer, uint32_t buffer_size) {
-    if (sockets_init()) {
-        return -1;
+    io_vec vec = {
+        .data = buffer,
+        .size = buffer_size,
+    };
+
+    return socket_readv(dest, owner, &vec, 1);
+}
+
+int socket_writev(const void *dest, const void *owner, const io_vec *vec, uint32_t count) {
+    ring_buffer       *ring = NULL;
+    socket_connection *conn = NULL;
+
+    int ret = sock_conn_ring(dest, owner, 1, &ring, &conn);
+    if (ret) {
+        return ret;
     }
 
-    socket_connection *conn = sock_find_conn(dest, 0);
-    if (!conn) {
-        return -2;
+    if (SOCKET_IS_DGRAM(conn->sock_ref)) {
+        ret = sock_dgram_writev(ring, vec, count);
+        if (ret <= 0) {
+            return ret;
+        }
+    } else {
+        ret = ring_writev(ring, vec, count);
     }
 
-    if (!CONNECTION_ESTABLISHED(conn)) {
-        return -3;
+    sock_stat_update(conn, owner, ring, ret);
+
+    return ret;
+}
+
+int socket_readv(const void *dest, const void *owner, const io_vec *vec, uint32_t count) {
+    ring_buffer       *ring = NULL;
+    socket_connection *conn = NULL;
+
+    int ret = sock_conn_ring(dest, owner, 0, &ring, &conn);
+    if (ret) {
+        return ret;
     }
 
-    socket_ctx *sock_ctx = conn->sock_ref;
+    if (SOCKET_IS_DGRAM(conn->sock_ref)) {
+        return sock_dgram_readv(ring, vec, count);
+    }
 
-    socket_io_buffer *buf_ctx = NULL;
+    int len = io_vec_size(vec, count);
+    if (len < 0) {
+        return -5;
+    }
 
-    uint8_t          *buf     = NULL;
+    return ring_readv(ring, vec, count, len);
+}
 
-    if (conn->client == owner) {
-        buf_ctx = (&conn->client_buffer);
+int socket_write_reserve(const void *dest, const void *owner, uint32_t size, void **ptr) {
+    ring_buffer       *ring = NULL;
+    socket_connection *conn = NULL;
 
-        buf = buf_ctx->buffer;
-    } else if (sock_ctx->owner == owner) {
-        buf_ctx = (&conn->owner_buffer);
+    int ret = sock_conn_ring(dest, owner, 1, &ring, &conn);
+    if (ret) {
+        return ret;
+    }
 
-        buf = buf_ctx->buffer;
-    } else {
-        return -4;
+    //! datagram header is placed right before the loaned region
+    uint32_t hdr = SOCKET_IS_DGRAM(conn->sock_ref) ? DGRAM_HDR_SIZE : 0;
+
+    if (size > UINT16_MAX) {
+        return -6;
     }
 
-    uint32_t count = 0;
+    size += hdr;
 
-    while (count < buffer_size) {
-        if (!buf_ctx->busy_count) {
-            break;
+    uint8_t *region = NULL;
+    uint32_t span   = ring_peek_write(ring, &region);
+    if (span < size) {
+        //! both sides are served by kernel: drained ring may be rewound
+        if (ring_rewind(ring)) {
+            return -5;
         }
 
-        buffer[count++] = *buf_ctx->rd_ptr++;
-        buf_ctx->busy_count--;
+        span = ring_peek_write(ring, &region);
+        if (span < size) {
+            return -6;
+        }
+    }
+
+    *ptr = region + hdr;
 
-        if (buf_ctx->rd_ptr >= (buf + buf_ctx->buffer_size)) {
-            buf_ctx->rd_ptr = buf;
+    return span - hdr;
+}
+
+int socket_write_commit(const void *dest, const void *owner, uint32_t size) {
+    ring_buffer       *ring = NULL;
+    socket_connection *conn = NULL;
+
+    int ret = sock_conn_ring(dest, owner, 1, &ring, &conn);
+    if (ret) {
+        return ret;
+    }
+
+    uint32_t hdr = SOCKET_IS_DGRAM(conn->sock_ref) ? DGRAM_HDR_SIZE : 0;
+
+    uint8_t *region = NULL;
+    if (size > UINT16_MAX || size + hdr > ring_peek_write(ring, &region)) {
+        return -5;
+    }
+
+    if (hdr) {
+        region[0] = size & 0xff;
+        region[1] = size >> 8;
+    }
+
+    ring_commit_write(ring, size + hdr);
+
+    sock_stat_update(conn, owner, ring, size);
+
+    return size;
+}
+
+int socket_read_peek(const void *dest, const void *owner, const void **ptr) {
+    ring_buffer       *ring = NULL;
+    socket_connection *conn = NULL;
+
+    int ret = sock_conn_ring(dest, owner, 0, &ring, &conn);
+    if (ret) {
+        return ret;
+    }
+
+    const uint8_t *region = NULL;
+    uint32_t       span   = ring_peek_read(ring, &region);
+
+    if (SOCKET_IS_DGRAM(conn->sock_ref)) {
+        int len = sock_dgram_len(ring);
+        if (len < 0) {
+            *ptr = NULL;
+
+            return 0;
+        }
+
+        //! only datagram laid out contiguously can be loaned
+        if (span < DGRAM_HDR_SIZE + len) {
+            return -5;
         }
+
+        *ptr = region + DGRAM_HDR_SIZE;
+
+        return len;
     }
 
-    return count;
+    *ptr = span ? region : NULL;
+
+    return span;
 }
 
-const
-void *socket_get_peer(const void *dest, const void *source) {
-    if (sockets_init()) {
-        return NULL;
+int socket_read_release(const void *dest, const void *owner, uint32_t size) {
+    ring_buffer       *ring = NULL;
+    socket_connection *conn = NULL;
+
+    int ret = sock_conn_ring(dest, owner, 0, &ring, &conn);
+    if (ret) {
+        return ret;
+    }
+
+    if (SOCKET_IS_DGRAM(conn->sock_ref)) {
+        int len = sock_dgram_len(ring);
+        if (len < 0 || size > (uint32_t) len) {
+            return -5;
+        }
+
+        //! datagram is released as a whole
+        ring_commit_read(ring, DGRAM_HDR_SIZE + len);
+
+        return size;
+    }
+
+    const uint8_t *region = NULL;
+    if (size > ring_peek_read(ring, &region)) {
+        return -5;
     }
 
+    ring_commit_read(ring, size);
+
+    return size;
+}
+
+const
+void *socket_get_peer(const void *dest, const void *source) {
     socket_connection *conn = sock_find_conn(dest, 0);
     if (conn) {
         if (!CONNECTION_ESTABLISHED(conn)) {
@@ -468,10 +741,6 @@ void *socket_get_peer(const void *dest, const void *source) {
 }
 
 int socket_close(const void *dest, const void *source) {
-    if (sockets_init()) {
-        return -1;
-    }
-
     if (is_sock(dest)) {
         socket_ctx *sock = (void *) dest;
 
@@ -479,6 +748,8 @@ int socket_close(const void *dest, const void *source) {
             return -2;
         }
 
+        sock_port_remove(sock);
+
         sock->connections->destroy(sock->connections, sock_conn_dstor);
 
         cell_free(sock);
@@ -492,10 +763,16 @@ int socket_close(const void *dest, const void *source) {
             socket_connection *conn = conn_node->ptr;
             socket_ctx *sock = conn->sock_ref;
 
-            if (sock->owner != source && conn->client != source) {
+            //! connection left by an exited client can be closed by anyone
+            if (sock->owner != source && conn->client != source &&
+                is_thread(conn->client)) {
                 return -3;
             }
 
+            if (!CONNECTION_ESTABLISHED(conn)) {
+                sock->backlog--;
+            }
+
             sock->connections->delete(sock->connections, conn_node, sock_conn_dstor);
 
             return 0;
@@ -506,31 +783,28 @@ int socket_close(const void *dest, const void *source) {
 }
 
 int is_sock(const void *sock) {
-    if (sockets_init()) {
-        return -1;
-    }
-
-    const list_node *node = socket_list->get_front(socket_list);
-
-    socket_ctx *sock_ctx = NULL;
-
-    while (node) {
-        sock_ctx = node->ptr;
-
-        if (sock_ctx == sock) {
+    for (uint32_t i = 0; i < port_count; i++) {
+        if (port_sockets[i] == sock) {
             return 1;
         }
-
-        node = node->nxt;
     }
 
     return 0;
 }
 
 int is_sock_conn(const void *conn) {
-    if (sockets_init()) {
+    return ((int) sock_find_conn(conn, 0));
+}
+
+int socket_stat_get(uint8_t port, socket_stat *stat) {
+    socket_ctx *ctx = sock_find_port(port);
+    if (!ctx || !stat) {
         return -1;
     }
 
-    return ((int) sock_find_conn(conn, 0));
+    memcpy(stat, &ctx->stat, sizeof(socket_stat));
+
+    stat->backlog = ctx->backlog;
+
+    return 0;
 }
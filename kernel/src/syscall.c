@@ -6,29 +6,27 @@
 #define CONNECT_TIMEOUT_MS 500
 
 void sleep(int msec) {
-    thread_delay(msec);
-    sv_call(SVC_RESCHEDULE, NULL);
+    sv_fast_call(SVC_FAST_SLEEP, msec, 0, 0);
 }
 
 void yield(void) {
-    thread_yield();
-    sv_call(SVC_RESCHEDULE, NULL);
+    sv_fast_call(SVC_FAST_YIELD, 0, 0, 0);
 }
 
 void wait(const void *object) {
-    thread_wait_request req = {
-        .object        = object,
-    };
+    sv_fast_call(SVC_FAST_WAIT, object, 0, 0);
+}
 
-    sv_call(SVC_WAIT, &req);
+void wait_cond(const void *object, const volatile uint32_t *word, uint32_t val) {
+    sv_fast_call(SVC_FAST_WAIT, object, word, val);
 }
 
 void signal(const void * object) {
-    thread_signal_request req = {
-        .object        = object,
-    };
+    sv_fast_call(SVC_FAST_SIGNAL, object, 0, 0);
+}
 
-    sv_call(SVC_WAKEUP, &req);
+uint32_t cycles(void) {
+    return sv_fast_call(SVC_FAST_CYCLES, 0, 0, 0);
 }
 
 void *malloc(uint32_t size) {
@@ -140,27 +138,154 @@ void *precv(void) {
 }
 
 int write(const void * dest, const void *data, uint32_t data_size) {
+    return sv_fast_call(SVC_FAST_WRITE, dest, data, data_size);
+}
+
+int read(const void * dest, void *data, uint32_t data_size) {
+    return sv_fast_call(SVC_FAST_READ, dest, data, data_size);
+}
+
+int sq_init(sv_queue *queue, sv_sqe *entries, uint32_t size) {
+    if (!queue || !entries || !RING_IS_POW2(size)) {
+        return -1;
+    }
+
+    queue->entries = entries;
+    queue->mask    = size - 1;
+    queue->head    = 0;
+    queue->tail    = 0;
+
+    return 0;
+}
+
+int sq_push(sv_queue *queue, sv_code code, void *req) {
+    uint32_t head = queue->head;
+
+    if (head - queue->tail > queue->mask) {
+        return -1;
+    }
+
+    queue->entries[head & queue->mask].code = code;
+    queue->entries[head & queue->mask].req  = req;
+
+    queue->head = head + 1;
+
+    return 0;
+}
+
+int submit(sv_queue *queue) {
+    submit_request req = {
+        .result    = -21,
+        .queue     = queue,
+    };
+
+    sv_call(SVC_SUBMIT, &req);
+
+    return req.result;
+}
+
+int timer_start(ted_timer *timer, uint32_t msecs, uint32_t period) {
+    timer_request req = {
+        .result    = -1,
+        .timer     = timer,
+        .msecs     = msecs,
+        .period    = period,
+    };
+
+    sv_call(SVC_TIMER_START, &req);
+
+    return req.result;
+}
+
+int timer_cancel(ted_timer *timer) {
+    timer_request req = {
+        .result    = 0,
+        .timer     = timer,
+    };
+
+    sv_call(SVC_TIMER_CANCEL, &req);
+
+    return req.result;
+}
+
+int writev(const void *dest, const io_vec *vec, uint32_t count) {
+    rwv_request req = {
+        .result    = 0,
+        .dest      = dest,
+        .vec       = vec,
+        .count     = count,
+    };
+
+    sv_call(SVC_WRITEV, &req);
+
+    return req.result;
+}
+
+int readv(const void *dest, const io_vec *vec, uint32_t count) {
+    rwv_request req = {
+        .result    = 0,
+        .dest      = dest,
+        .vec       = vec,
+        .count     = count,
+    };
+
+    sv_call(SVC_READV, &req);
+
+    return req.result;
+}
+
+int write_reserve(const void *dest, uint32_t size, void **ptr) {
     rw_request req = {
         .result    = 0,
         .dest      = dest,
-        .data      = (void *) data,
-        .data_size = data_size,
+        .data      = NULL,
+        .data_size = size,
     };
 
-    sv_call(SVC_WRITE, &req);
+    sv_call(SVC_WRITE_RESERVE, &req);
+
+    *ptr = req.data;
 
     return req.result;
 }
 
-int read(const void * dest, void *data, uint32_t data_size) {
+int write_commit(const void *dest, uint32_t size) {
+    rw_request req = {
+        .result    = 0,
+        .dest      = dest,
+        .data      = NULL,
+        .data_size = size,
+    };
+
+    sv_call(SVC_WRITE_COMMIT, &req);
+
+    return req.result;
+}
+
+int read_peek(const void *dest, const void **ptr) {
+    rw_request req = {
+        .result    = 0,
+        .dest      = dest,
+        .data      = NULL,
+        .data_size = 0,
+    };
+
+    sv_call(SVC_READ_PEEK, &req);
+
+    *ptr = req.data;
+
+    return req.result;
+}
+
+int read_release(const void *dest, uint32_t size) {
     rw_request req = {
         .result    = 0,
         .dest      = dest,
-        .data      = (void *) data,
-        .data_size = data_size,
+        .data      = NULL,
+        .data_size = size,
     };
 
-    sv_call(SVC_READ, &req);
+    sv_call(SVC_READ_RELEASE, &req);
 
     return req.result;
 }
@@ -188,10 +313,11 @@ int close(const void * dest) {
     return req.result;
 }
 
-int socket(uint8_t port) {
+int socket(uint8_t port, uint8_t mode) {
     socket_open_request req = {
         .result             = -21,
         .port               = port,
+        .mode               = mode,
     };
 
     sv_call(SVC_SOCK_OPEN, &req);
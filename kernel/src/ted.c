@@ -1,104 +1,182 @@
 #include "kernel/ted.h"
-#include "kernel/memory.h"
 #include "platform/clock.h"
-#include "lib/list.h"
 
-typedef struct ted_event_ctx_t {
-    ted_event     handler;
-    void         *ctx;
+/**
+ * hierarchical timing wheel: level N slot spans 32^N mseconds, timers
+ * are moved (cascaded) one level down when lower level wraps
+ */
+#define TED_LEVEL_BITS   5
+#define TED_LEVEL_SIZE   (1 << TED_LEVEL_BITS)
+#define TED_LEVEL_MASK   (TED_LEVEL_SIZE - 1)
+#define TED_LEVELS       4
 
-    int32_t      time;
-} ted_event_ctx;
+//! timers further than wheel range are parked in the last slot reachable
+#define TED_MAX_DELTA    ((1 << (TED_LEVEL_BITS * TED_LEVELS)) - 1)
 
 static
-list_ifc     *ted_event_queue = NULL;
+ted_timer *ted_wheel[TED_LEVELS][TED_LEVEL_SIZE] = {{NULL}};
 
+//! next msecond to process (tracks SysTick from boot)
 static
-int ted_init(void) {
-    if (ted_event_queue) {
-        return -1;
+int32_t    ted_base = 0;
+
+static inline
+void ted_link(ted_timer **head, ted_timer *timer) {
+    timer->nxt = *head;
+    if (timer->nxt) {
+        timer->nxt->pprev = &timer->nxt;
     }
 
-    ted_event_queue = list_create();
-    if (!ted_event_queue) {
-        return -2;
+    *head = timer;
+    timer->pprev = head;
+}
+
+static inline
+void ted_unlink(ted_timer *timer) {
+    *timer->pprev = timer->nxt;
+    if (timer->nxt) {
+        timer->nxt->pprev = timer->pprev;
     }
 
-    return 0;
+    timer->nxt   = NULL;
+    timer->pprev = NULL;
 }
 
-static const
-list_node *find_suitable_node(int32_t time) {
-    const list_node *node = ted_event_queue->get_front(ted_event_queue);
+static
+void ted_insert(ted_timer *timer) {
+    int32_t  delta   = timer->expires - ted_base;
+    uint32_t expires = timer->expires;
+
+    if (delta < 0) {
+        //! overdue: run on the next processed msecond
+        expires = ted_base;
+        delta   = 0;
+    } else if (delta > TED_MAX_DELTA) {
+        expires = ted_base + TED_MAX_DELTA;
+        delta   = TED_MAX_DELTA;
+    }
 
-    while (node) {
-        ted_event_ctx *ctx = node->ptr;
+    uint32_t level = 0;
+    while (level < TED_LEVELS - 1 &&
+        (uint32_t) delta >= (1u << (TED_LEVEL_BITS * (level + 1)))) {
+        level++;
+    }
 
-        if (ctx->time > time) {
-            break;
-        }
+    uint32_t slot = (expires >> (TED_LEVEL_BITS * level)) & TED_LEVEL_MASK;
 
-        if (!node->nxt) {
-            return NULL;
-        }
+    ted_link(&ted_wheel[level][slot], timer);
+}
 
-        node = node->nxt;
-    }
+/**
+ * @brief      re-insert all timers of the slot (they land on lower levels)
+ */
+static
+void ted_cascade(uint32_t level, uint32_t slot) {
+    ted_timer *list = ted_wheel[level][slot];
+
+    ted_wheel[level][slot] = NULL;
+
+    while (list) {
+        ted_timer *timer = list;
 
-    return node;
+        list = timer->nxt;
+
+        timer->nxt   = NULL;
+        timer->pprev = NULL;
+
+        ted_insert(timer);
+    }
 }
 
-int ted_schedule(ted_event event, void *event_ctx, uint32_t msecs) {
-    if (!ted_event_queue && ted_init()) {
-        return -1;
+/**
+ * @brief      process one msecond (time MUST be equal to ted_base)
+ */
+static
+void ted_process(int32_t time) {
+    uint32_t slot = time & TED_LEVEL_MASK;
+
+    //! level wrapped: pull next span of upper level down
+    for (uint32_t level = 1; level < TED_LEVELS && !slot; level++) {
+        slot = (time >> (TED_LEVEL_BITS * level)) & TED_LEVEL_MASK;
+
+        ted_cascade(level, slot);
     }
 
-    ted_event_ctx *ctx = cell_alloc(sizeof(ted_event_ctx));
-    if (!ctx) {
-        return -2;
+    //! detach expired slot: callbacks may start/cancel timers
+    ted_timer *expired = NULL;
+    ted_timer **head   = &ted_wheel[0][time & TED_LEVEL_MASK];
+
+    if (*head) {
+        expired = *head;
+        expired->pprev = &expired;
+        *head = NULL;
     }
 
-    ctx->handler = event;
-    ctx->time    = clock_get() + msecs;
-    ctx->ctx     = event_ctx;
+    //! timers armed from callbacks are due no earlier than next msecond
+    ted_base = time + 1;
 
-    const list_node *node = find_suitable_node(ctx->time);
+    while (expired) {
+        ted_timer *timer = expired;
 
-    if (node) {
-        if (!ted_event_queue->insert_before(ted_event_queue,
-            node, ctx)) {
-            return -3;
+        ted_unlink(timer);
+
+        //! parked timer is not due yet
+        if (timer->expires - time > 0) {
+            ted_insert(timer);
+            continue;
         }
-    } else {
-        if (!ted_event_queue->insert_after(ted_event_queue,
-            node, ctx)) {
-            return -3;
+
+        if (timer->period) {
+            timer->expires += timer->period;
+            ted_insert(timer);
         }
+
+        timer->handler(timer->ctx);
     }
+}
 
+void ted_timer_init(ted_timer *timer, ted_event event, void *ctx) {
+    if (!timer) {
+        return;
+    }
 
+    memset(timer, 0, sizeof(ted_timer));
 
-    return 0;
+    timer->handler = event;
+    timer->ctx     = ctx;
 }
 
-void ted_dispatch(void) {
-    if (!ted_event_queue && ted_init()) {
-        return;
+int ted_timer_start(ted_timer *timer, uint32_t msecs, uint32_t period) {
+    if (!timer || !timer->handler) {
+        return -1;
     }
 
-    const list_node *node = ted_event_queue->get_front(ted_event_queue);
+    if (ted_timer_pending(timer)) {
+        ted_unlink(timer);
+    }
 
-    ted_event_ctx *ctx = (node) ? node->ptr : NULL;
+    timer->expires = clock_get() + msecs;
+    timer->period  = period;
 
-    int32_t now = clock_get();
+    ted_insert(timer);
 
-    while (node && (now - ctx->time) < 0) {
-        ctx = node->ptr;
+    return 0;
+}
 
-        ctx->handler(ctx->ctx);
+int ted_timer_cancel(ted_timer *timer) {
+    if (!timer || !ted_timer_pending(timer)) {
+        return 0;
+    }
+
+    ted_unlink(timer);
 
-        ted_event_queue->delete(ted_event_queue, node, cell_free);
+    timer->period = 0;
+
+    return 1;
+}
 
-        node = ted_event_queue->get_front(ted_event_queue);
+void ted_tick(int32_t now) {
+    while (now - ted_base >= 0) {
+        ted_process(ted_base);
     }
 }
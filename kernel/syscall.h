@@ -2,6 +2,7 @@
 #define KERNEL_SYSCALL_H
 
 #include "arch/svc.h"
+#include "kernel/socket.h"
 
 typedef enum service_ports_t {
     VFS_PORT = 0x00,
@@ -12,10 +13,27 @@ void yield(void);
 
 void wait(const void *object);
 
+/**
+ * @brief      wait for object signal unless word differs from given value
+ *
+ * Check is atomic with respect to interrupts: a signal sent after word
+ * was updated is never lost.
+ *
+ * @param[in]  object  object to wait for
+ * @param[in]  word    condition word
+ * @param[in]  val     value observed by caller
+ */
+void wait_cond(const void *object, const volatile uint32_t *word, uint32_t val);
+
 void signal(const void *object);
 
 void sleep(int msec);
 
+/**
+ * @brief      get DWT cycle counter
+ */
+uint32_t cycles(void);
+
 void *malloc(uint32_t size);
 
 void *zmalloc(uint32_t size);
@@ -32,6 +50,11 @@ void *get_thread(const char *name);
 
 int destroy_thread(const void * thread);
 
+/**
+ * @brief      open pipe to thread
+ *
+ * NOTE: pipe capacity is `buffer_size` rounded down to a power of two
+ */
 const
 void *popen(const void *dest_thread, uint8_t *buffer, uint32_t buffer_size);
 
@@ -42,12 +65,74 @@ int write(const void * dest, const void *data, uint32_t data_size);
 
 int read(const void * dest, void *data, uint32_t data_size);
 
+/**
+ * @brief      initialize submission queue
+ *
+ * @param      queue    submission queue
+ * @param      entries  entries storage
+ * @param[in]  size     number of entries (MUST be a power of two)
+ *
+ * @return     0 in case of success, otherwise negative
+ */
+int sq_init(sv_queue *queue, sv_sqe *entries, uint32_t size);
+
+/**
+ * @brief      queue request, it is executed on next submit
+ *
+ * @param      queue  submission queue
+ * @param[in]  code   supervisor call code
+ * @param      req    request structure (MUST stay valid until completion)
+ *
+ * @return     0 in case of success, -1 if queue is full
+ */
+int sq_push(sv_queue *queue, sv_code code, void *req);
+
+/**
+ * @brief      execute all queued requests with a single supervisor call
+ *
+ * @return     number of executed requests, otherwise negative
+ */
+int submit(sv_queue *queue);
+
+/**
+ * @brief      (re)arm tick timer (see ted_timer_start)
+ *
+ * NOTE: callback runs in SysTick interrupt context: it MUST NOT issue
+ *       supervisor calls, use it to signal a waiting thread instead
+ *
+ * @param      timer   initialized timer (MUST stay valid while pending)
+ * @param[in]  msecs   delay before first expiration
+ * @param[in]  period  re-arm period (0 - one shot)
+ *
+ * @return     0 in case of success, otherwise negative
+ */
+int timer_start(ted_timer *timer, uint32_t msecs, uint32_t period);
+
+/**
+ * @brief      cancel tick timer
+ *
+ * @return     1 if timer was pending, 0 otherwise
+ */
+int timer_cancel(ted_timer *timer);
+
+int writev(const void *dest, const io_vec *vec, uint32_t count);
+
+int readv(const void *dest, const io_vec *vec, uint32_t count);
+
+int write_reserve(const void *dest, uint32_t size, void **ptr);
+
+int write_commit(const void *dest, uint32_t size);
+
+int read_peek(const void *dest, const void **ptr);
+
+int read_release(const void *dest, uint32_t size);
+
 const
 void *peer(const void *dest);
 
 int close(const void * dest);
 
-int socket(uint8_t port);
+int socket(uint8_t port, uint8_t mode);
 
 const
 void *connect(uint8_t port, uint32_t buffer_size);
@@ -6,8 +6,68 @@
 
 typedef void (*ted_event)(void *ctx);
 
-int ted_schedule(ted_event event, void *event_ctx, uint32_t msecs);
+/**
+ * timer (cancellation handle), storage is owned by caller and MUST stay
+ * valid while timer is pending
+ */
+typedef struct ted_timer_t {
+    struct ted_timer_t   *nxt;
+    struct ted_timer_t  **pprev;
 
-void ted_dispatch(void);
+    ted_event             handler;
+    void                 *ctx;
+
+    int32_t               expires;
+    /**
+     * re-arm period in mseconds (0 - one shot)
+     */
+    uint32_t              period;
+} ted_timer;
+
+/**
+ * @brief      initialize timer
+ *
+ * @param      timer  timer
+ * @param[in]  event  callback
+ * @param      ctx    callback argument
+ */
+void ted_timer_init(ted_timer *timer, ted_event event, void *ctx);
+
+/**
+ * @brief      (re)arm timer, O(1)
+ *
+ * NOTE: callback runs in SysTick interrupt context: it MUST be short and
+ *       MUST NOT issue supervisor calls (wake a thread with thread_signal
+ *       for anything heavier)
+ *
+ * @param      timer   timer
+ * @param[in]  msecs   delay before first expiration
+ * @param[in]  period  re-arm period (0 - one shot)
+ *
+ * @return     0 in case of success, otherwise negative
+ */
+int ted_timer_start(ted_timer *timer, uint32_t msecs, uint32_t period);
+
+/**
+ * @brief      cancel timer, O(1)
+ *
+ * @return     1 if timer was pending, 0 otherwise
+ */
+int ted_timer_cancel(ted_timer *timer);
+
+/**
+ * @brief      check if timer is pending
+ */
+static inline
+int ted_timer_pending(const ted_timer *timer) {
+    return timer->pprev != NULL;
+}
+
+/**
+ * @brief      advance timer wheel up to given time and run expired timers
+ *
+ * @param[in]  now   current time in mseconds
+ */
+void ted_tick(int32_t now);
 
 #endif
@@ -0,0 +1,57 @@
+#ifndef LIB_CRC_H
+#define LIB_CRC_H
+
+#include "common/common.h"
+
+/**
+ * CRC kernels, chosen by flash budget:
+ *   0 - bitwise, no tables
+ *   1 - byte tables (CRC7 256 B, CRC16 512 B)
+ *   4 - CRC16 slice-by-4 (2 KiB) and CRC7 byte table
+ */
+#ifndef CRC_TABLES
+#define CRC_TABLES 4
+#endif
+
+#define CRC16_INIT 0x0000
+#define CRC7_INIT  0x00
+
+/**
+ * @brief      update CRC7 (x^7 + x^3 + 1, SD/MMC commands)
+ *
+ * CRC is kept left aligned: bits 7..1 hold the CRC, bit 0 is zero, so
+ * SD command byte is `crc | 0x01`.
+ *
+ * @param[in]  crc   current CRC (CRC7_INIT to start)
+ * @param[in]  buf   data
+ * @param[in]  len   data length
+ *
+ * @return     updated CRC
+ */
+uint8_t crc7_update(uint8_t crc, const uint8_t *buf, uint32_t len);
+
+/**
+ * @brief      update CRC16-CCITT (x^16 + x^12 + x^5 + 1, zero init,
+ *             "XMODEM", SD data blocks)
+ *
+ * Blocks may be fed in any split, result is the same.
+ *
+ * @param[in]  crc   current CRC (CRC16_INIT to start)
+ * @param[in]  buf   data
+ * @param[in]  len   data length
+ *
+ * @return     updated CRC
+ */
+uint16_t crc16_update(uint16_t crc, const uint8_t *buf, uint32_t len);
+
+static inline
+uint8_t crc7(const uint8_t *buf, uint32_t len) {
+    return crc7_update(CRC7_INIT, buf, len);
+}
+
+static inline
+uint16_t crc16(const uint8_t *buf, uint32_t len) {
+    return crc16_update(CRC16_INIT, buf, len);
+}
+
+#endif
@@ -0,0 +1,98 @@
+#ifndef LIB_FORMAT_H
+#define LIB_FORMAT_H
+
+#include "common/common.h"
+#include "lib/ring.h"
+#include "platform/usart.h"
+
+/**
+ * @brief      formatted output destination
+ *
+ * Engine passes literal spans and converted fields to `write` as is, no
+ * intermediate buffer is used. Concrete sinks embed this structure as
+ * the first member.
+ */
+typedef struct fmt_sink_t {
+    /**
+     * @brief      consume output chunk
+     *
+     * @param      sink  sink
+     * @param[in]  data  chunk (not null terminated)
+     * @param[in]  len   chunk length
+     */
+    void (*write)(struct fmt_sink_t *sink, const char *data, uint32_t len);
+} fmt_sink;
+
+/**
+ * memory buffer sink, output is truncated and kept null terminated
+ */
+typedef struct fmt_buffer_sink_t {
+    fmt_sink               sink;
+    char                  *pos;
+    /**
+     * bytes left excluding terminator
+     */
+    uint32_t               room;
+} fmt_buffer_sink;
+
+/**
+ * ring sink, output which doesn't fit is dropped
+ */
+typedef struct fmt_ring_sink_t {
+    fmt_sink               sink;
+    ring_buffer           *ring;
+} fmt_ring_sink;
+
+/**
+ * usart sink, spans are sent with a single transmit call
+ */
+typedef struct fmt_usart_sink_t {
+    fmt_sink               sink;
+    usart_iface           *iface;
+} fmt_usart_sink;
+
+/**
+ * @brief      initialize buffer sink
+ *
+ * @param      sink    sink
+ * @param      buffer  destination
+ * @param[in]  size    destination size (including terminator)
+ */
+void fmt_buffer_sink_init(fmt_buffer_sink *sink, char *buffer, uint32_t size);
+
+/**
+ * @brief      initialize ring sink
+ *
+ * @param      sink  sink
+ * @param      ring  destination ring (sink is its producer)
+ */
+void fmt_ring_sink_init(fmt_ring_sink *sink, ring_buffer *ring);
+
+/**
+ * @brief      initialize usart sink
+ *
+ * @param      sink   sink
+ * @param      iface  usart interface
+ */
+void fmt_usart_sink_init(fmt_usart_sink *sink, usart_iface *iface);
+
+/**
+ * @brief      format data into sink
+ *
+ * Conversion: %[0][width]{d,u,x,X,c,s}, other characters after '%' are
+ * put as is ("%%" gives '%').
+ *
+ * @param      sink  output sink
+ * @param[in]  fmt   formatting string
+ * @param[in]  va    arguments
+ *
+ * @return     number of characters produced
+ */
+int vformat(fmt_sink *sink, const char *fmt, va_list va);
+
+/**
+ * @brief      format data into sink (see vformat)
+ */
+int format(fmt_sink *sink, const char *fmt, ...);
+
+#endif
@@ -0,0 +1,39 @@
+#ifndef LIB_IO_VEC_H
+#define LIB_IO_VEC_H
+
+#include "common/common.h"
+
+/**
+ * @brief      buffer segment for vectored copies
+ */
+typedef struct io_vec_t {
+    void                 *data;
+    uint32_t              size;
+} io_vec;
+
+/**
+ * max number of segments in one vectored request
+ */
+#define IO_VEC_MAX 8
+
+/**
+ * @brief      get total size of segments
+ *
+ * @return     total size, -1 if it doesn't fit a byte count result (int)
+ */
+static inline
+int io_vec_size(const io_vec *vec, uint32_t count) {
+    uint32_t size = 0;
+
+    for (uint32_t i = 0; i < count; i++) {
+        if (vec[i].size > INT32_MAX - size) {
+            return -1;
+        }
+
+        size += vec[i].size;
+    }
+
+    return size;
+}
+
+#endif
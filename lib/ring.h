@@ -0,0 +1,214 @@
+#ifndef LIB_RING_H
+#define LIB_RING_H
+
+#include "common/common.h"
+#include "common/def.h"
+#include "lib/io_vec.h"
+
+/**
+ * @brief      byte ring buffer
+ *
+ * Size is a power of two, so head/tail are free-running counters and
+ * wrap with a mask. Producer touches only `head`, consumer only `tail`:
+ * one producer and one consumer may run in different contexts (thread
+ * and ISR) without locking.
+ */
+typedef struct ring_buffer_t {
+    uint8_t              *buffer;
+    uint32_t              mask;
+
+    volatile uint32_t     head;
+    volatile uint32_t     tail;
+} ring_buffer;
+
+/**
+ * @brief      check that value is a power of two
+ */
+#define RING_IS_POW2(_size) ((_size) && !((_size) & ((_size) - 1)))
+
+/**
+ * @brief      initialize ring over given storage
+ *
+ * @param      ring    ring buffer
+ * @param      buffer  storage
+ * @param[in]  size    storage size (MUST be a power of two)
+ *
+ * @return     0 in case of success, otherwise negative
+ */
+int ring_init(ring_buffer *ring, uint8_t *buffer, uint32_t size);
+
+/**
+ * @brief      round size up to the nearest power of two
+ *
+ * @param[in]  size  desired size
+ *
+ * @return     power of two not less than size (0 on overflow)
+ */
+uint32_t ring_size_round_up(uint32_t size);
+
+/**
+ * @brief      round size down to the nearest power of two
+ *
+ * @param[in]  size  desired size
+ *
+ * @return     power of two not greater than size (0 if size is 0)
+ */
+uint32_t ring_size_round_down(uint32_t size);
+
+/**
+ * @brief      get ring capacity
+ */
+static inline
+uint32_t ring_size(const ring_buffer *ring) {
+    return ring->mask + 1;
+}
+
+/**
+ * @brief      get number of bytes ready to be read
+ */
+static inline
+uint32_t ring_used(const ring_buffer *ring) {
+    return ring->head - ring->tail;
+}
+
+/**
+ * @brief      get number of bytes ready to be written
+ */
+static inline
+uint32_t ring_free(const ring_buffer *ring) {
+    return ring_size(ring) - ring_used(ring);
+}
+
+/**
+ * @brief      drop all data
+ *
+ * NOTE: consumer side operation
+ */
+static inline
+void ring_reset(ring_buffer *ring) {
+    ring->tail = ring->head;
+}
+
+/**
+ * @brief      move indices of empty ring to the start of storage, so the
+ *             whole ring becomes one contiguous writable region
+ *
+ * NOTE: caller MUST own both producer and consumer side
+ *
+ * @param      ring  ring buffer
+ *
+ * @return     0 in case of success, -1 if ring is not empty
+ */
+static inline
+int ring_rewind(ring_buffer *ring) {
+    if (ring_used(ring)) {
+        return -1;
+    }
+
+    ring->head = ring->tail = (ring->head + ring->mask) & ~ring->mask;
+
+    return 0;
+}
+
+/**
+ * @brief      copy data into ring (two bulk copies at most)
+ *
+ * @param      ring  ring buffer
+ * @param[in]  data  source buffer
+ * @param[in]  len   bytes to write
+ *
+ * @return     number of bytes written (limited by free space)
+ */
+uint32_t ring_write(ring_buffer *ring, const void *data, uint32_t len);
+
+/**
+ * @brief      copy data out of ring (two bulk copies at most)
+ *
+ * @param      ring  ring buffer
+ * @param      data  destination buffer
+ * @param[in]  len   bytes to read
+ *
+ * @return     number of bytes read (limited by used space)
+ */
+uint32_t ring_read(ring_buffer *ring, void *data, uint32_t len);
+
+/**
+ * @brief      gather segments into ring
+ *
+ * @param      ring   ring buffer
+ * @param[in]  vec    source segments
+ * @param[in]  count  number of segments
+ *
+ * @return     number of bytes written (limited by free space)
+ */
+uint32_t ring_writev(ring_buffer *ring, const io_vec *vec, uint32_t count);
+
+/**
+ * @brief      scatter ring data into segments
+ *
+ * @param      ring   ring buffer
+ * @param[in]  vec    destination segments
+ * @param[in]  count  number of segments
+ * @param[in]  len    bytes to read at most
+ *
+ * @return     number of bytes read (limited by used space)
+ */
+uint32_t ring_readv(ring_buffer *ring, const io_vec *vec, uint32_t count, uint32_t len);
+
+/**
+ * @brief      get contiguous writable region
+ *
+ * @param      ring  ring buffer
+ * @param      ptr   start of region (output)
+ *
+ * @return     region length (may be less than free space at the wrap point)
+ */
+uint32_t ring_peek_write(ring_buffer *ring, uint8_t **ptr);
+
+/**
+ * @brief      publish bytes filled in place after ring_peek_write
+ *
+ * @param      ring  ring buffer
+ * @param[in]  len   bytes to publish
+ */
+void ring_commit_write(ring_buffer *ring, uint32_t len);
+
+/**
+ * @brief      get contiguous readable region
+ *
+ * @param      ring  ring buffer
+ * @param      ptr   start of region (output)
+ *
+ * @return     region length (may be less than used space at the wrap point)
+ */
+uint32_t ring_peek_read(ring_buffer *ring, const uint8_t **ptr);
+
+/**
+ * @brief      release bytes consumed in place after ring_peek_read
+ *
+ * @param      ring  ring buffer
+ * @param[in]  len   bytes to release
+ */
+void ring_commit_read(ring_buffer *ring, uint32_t len);
+
+/**
+ * @brief      put single byte (ISR friendly)
+ *
+ * @param      ring  ring buffer
+ * @param[in]  byte  byte to put
+ *
+ * @return     0 in case of success, -1 if ring is full
+ */
+int ring_put(ring_buffer *ring, uint8_t byte);
+
+/**
+ * @brief      get single byte (ISR friendly)
+ *
+ * @param      ring  ring buffer
+ * @param      byte  byte (output)
+ *
+ * @return     0 in case of success, -1 if ring is empty
+ */
+int ring_get(ring_buffer *ring, uint8_t *byte);
+
+#endif
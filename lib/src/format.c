@@ -0,0 +1,234 @@
+#include "lib/format.h"
+#include "lib/string.h"
+
+//! enough for 32 bit value in any supported radix
+#define FMT_NUM_MAX 12
+
+static const char fmt_digits_lower[] = "0123456789abcdef";
+static const char fmt_digits_upper[] = "0123456789ABCDEF";
+
+static const char fmt_fill_zero[]    = "0000000000000000";
+static const char fmt_fill_space[]   = "                ";
+
+/**
+ * @brief      convert to decimal, digits are put backwards from `end`
+ *
+ * @return     first digit
+ */
+static inline
+char *fmt_dec(char *end, uint32_t value) {
+    do {
+        *--end = '0' + value % 10;
+        value /= 10;
+    } while (value);
+
+    return end;
+}
+
+/**
+ * @brief      convert to hex, digits are put backwards from `end`
+ *
+ * @return     first digit
+ */
+static inline
+char *fmt_hex(char *end, uint32_t value, const char *digits) {
+    do {
+        *--end = digits[value & 0xf];
+        value >>= 4;
+    } while (value);
+
+    return end;
+}
+
+static
+void fmt_fill(fmt_sink *sink, const char *fill, uint32_t count) {
+    while (count) {
+        uint32_t chunk = count < sizeof(fmt_fill_zero) - 1 ?
+            count : sizeof(fmt_fill_zero) - 1;
+
+        sink->write(sink, fill, chunk);
+
+        count -= chunk;
+    }
+}
+
+int vformat(fmt_sink *sink, const char *fmt, va_list va) {
+    int total = 0;
+
+    while (*fmt) {
+        const char *span = fmt;
+
+        //! literal text goes out as one chunk
+        while (*fmt && *fmt != '%') {
+            fmt++;
+        }
+
+        if (fmt != span) {
+            sink->write(sink, span, fmt - span);
+            total += fmt - span;
+        }
+
+        if (!*fmt++) {
+            break;
+        }
+
+        const char *fill  = fmt_fill_space;
+        uint32_t    width = 0;
+
+        if (*fmt == '0') {
+            fill = fmt_fill_zero;
+            fmt++;
+        }
+
+        while (*fmt >= '0' && *fmt <= '9') {
+            width = width * 10 + (*fmt++ - '0');
+        }
+
+        char        num[FMT_NUM_MAX];
+        char       *digits;
+        const char *str;
+        const char *end  = num + sizeof(num);
+
+        switch (*fmt) {
+            case 0:
+                return total;
+            case 'd': {
+                int32_t value = va_arg(va, int32_t);
+
+                digits = fmt_dec(num + sizeof(num),
+                    value < 0 ? -(uint32_t) value : (uint32_t) value);
+                if (value < 0) {
+                    *--digits = '-';
+                }
+                str = digits;
+                break;
+            }
+            case 'u':
+                str = fmt_dec(num + sizeof(num), va_arg(va, uint32_t));
+                break;
+            case 'x':
+                str = fmt_hex(num + sizeof(num), va_arg(va, uint32_t),
+                    fmt_digits_lower);
+                break;
+            case 'X':
+                str = fmt_hex(num + sizeof(num), va_arg(va, uint32_t),
+                    fmt_digits_upper);
+                break;
+            case 'c':
+                num[0] = (char) va_arg(va, int);
+                str    = num;
+                end    = num + 1;
+                break;
+            case 's':
+                str = va_arg(va, const char*);
+                if (!str) {
+                    str = "(null)";
+                }
+                end = str + strlen(str);
+                break;
+            default:
+                str = fmt;
+                end = fmt + 1;
+                break;
+        }
+
+        fmt++;
+
+        uint32_t len = end - str;
+        uint32_t pad = width > len ? width - len : 0;
+
+        if (pad) {
+            //! sign goes before zeros
+            if (*str == '-' && fill == fmt_fill_zero && *(fmt - 1) == 'd') {
+                sink->write(sink, str++, 1);
+            }
+
+            fmt_fill(sink, fill, pad);
+        }
+
+        sink->write(sink, str, end - str);
+
+        total += len + pad;
+    }
+
+    return total;
+}
+
+int format(fmt_sink *sink, const char *fmt, ...) {
+    int ret;
+    va_list va;
+    va_start(va, fmt);
+    ret = vformat(sink, fmt, va);
+    va_end(va);
+
+    return ret;
+}
+
+static
+void fmt_buffer_write(fmt_sink *sink, const char *data, uint32_t len) {
+    fmt_buffer_sink *buf = (fmt_buffer_sink*) sink;
+    char            *pos = buf->pos;
+
+    if (!pos) {
+        return;
+    }
+
+    if (len > buf->room) {
+        len = buf->room;
+    }
+
+    buf->room -= len;
+
+    //! chunks are short: plain loop beats a memcpy call
+    const char *end = data + len;
+    while (data < end) {
+        *pos++ = *data++;
+    }
+
+    *pos = '\0';
+
+    buf->pos = pos;
+}
+
+void fmt_buffer_sink_init(fmt_buffer_sink *sink, char *buffer, uint32_t size) {
+    sink->sink.write = fmt_buffer_write;
+
+    if (!buffer || !size) {
+        sink->pos  = NULL;
+        sink->room = 0;
+        return;
+    }
+
+    sink->pos  = buffer;
+    sink->room = size - 1;
+
+    *buffer = '\0';
+}
+
+static
+void fmt_ring_write(fmt_sink *sink, const char *data, uint32_t len) {
+    fmt_ring_sink *ring = (fmt_ring_sink*) sink;
+
+    ring_write(ring->ring, data, len);
+}
+
+void fmt_ring_sink_init(fmt_ring_sink *sink, ring_buffer *ring) {
+    sink->sink.write = fmt_ring_write;
+    sink->ring       = ring;
+}
+
+static
+void fmt_usart_write(fmt_sink *sink, const char *data, uint32_t len) {
+    usart_iface *iface = ((fmt_usart_sink*) sink)->iface;
+
+    if (len == 1) {
+        iface->putc(iface, *data);
+    } else {
+        iface->nputs(iface, data, len);
+    }
+}
+
+void fmt_usart_sink_init(fmt_usart_sink *sink, usart_iface *iface) {
+    sink->sink.write = fmt_usart_write;
+    sink->iface      = iface;
+}
@@ -0,0 +1,197 @@
+#include "lib/ring.h"
+
+//! order data accesses against index update (single producer/consumer)
+#define RING_BARRIER() __sync_synchronize()
+
+int ring_init(ring_buffer *ring, uint8_t *buffer, uint32_t size) {
+    if (!ring || !buffer || !RING_IS_POW2(size)) {
+        return -1;
+    }
+
+    ring->buffer = buffer;
+    ring->mask   = size - 1;
+    ring->head   = 0;
+    ring->tail   = 0;
+
+    return 0;
+}
+
+uint32_t ring_size_round_up(uint32_t size) {
+    if (size <= 1) {
+        return 1;
+    }
+
+    if (size > 0x80000000u) {
+        return 0;
+    }
+
+    return 1u << (32 - __builtin_clz(size - 1));
+}
+
+uint32_t ring_size_round_down(uint32_t size) {
+    if (!size) {
+        return 0;
+    }
+
+    return 1u << (31 - __builtin_clz(size));
+}
+
+uint32_t ring_peek_write(ring_buffer *ring, uint8_t **ptr) {
+    uint32_t head  = ring->head;
+    uint32_t space = ring_size(ring) - (head - ring->tail);
+    uint32_t idx   = head & ring->mask;
+
+    if (space > ring_size(ring) - idx) {
+        space = ring_size(ring) - idx;
+    }
+
+    *ptr = ring->buffer + idx;
+
+    return space;
+}
+
+void ring_commit_write(ring_buffer *ring, uint32_t len) {
+    RING_BARRIER();
+
+    ring->head += len;
+}
+
+uint32_t ring_peek_read(ring_buffer *ring, const uint8_t **ptr) {
+    uint32_t tail  = ring->tail;
+    uint32_t avail = ring->head - tail;
+    uint32_t idx   = tail & ring->mask;
+
+    RING_BARRIER();
+
+    if (avail > ring_size(ring) - idx) {
+        avail = ring_size(ring) - idx;
+    }
+
+    *ptr = ring->buffer + idx;
+
+    return avail;
+}
+
+void ring_commit_read(ring_buffer *ring, uint32_t len) {
+    RING_BARRIER();
+
+    ring->tail += len;
+}
+
+uint32_t ring_write(ring_buffer *ring, const void *data, uint32_t len) {
+    const uint8_t *src   = data;
+    uint32_t       count = 0;
+
+    //! at most two segments: up to the wrap point and from the start
+    while (count < len) {
+        uint8_t *ptr;
+        uint32_t chunk = ring_peek_write(ring, &ptr);
+        if (!chunk) {
+            break;
+        }
+
+        if (chunk > len - count) {
+            chunk = len - count;
+        }
+
+        memcpy(ptr, src + count, chunk);
+
+        ring_commit_write(ring, chunk);
+
+        count += chunk;
+    }
+
+    return count;
+}
+
+uint32_t ring_read(ring_buffer *ring, void *data, uint32_t len) {
+    uint8_t *dst   = data;
+    uint32_t count = 0;
+
+    while (count < len) {
+        const uint8_t *ptr;
+        uint32_t chunk = ring_peek_read(ring, &ptr);
+        if (!chunk) {
+            break;
+        }
+
+        if (chunk > len - count) {
+            chunk = len - count;
+        }
+
+        memcpy(dst + count, ptr, chunk);
+
+        ring_commit_read(ring, chunk);
+
+        count += chunk;
+    }
+
+    return count;
+}
+
+uint32_t ring_writev(ring_buffer *ring, const io_vec *vec, uint32_t count) {
+    uint32_t total = 0;
+
+    for (uint32_t i = 0; i < count; i++) {
+        uint32_t written = ring_write(ring, vec[i].data, vec[i].size);
+
+        total += written;
+
+        if (written < vec[i].size) {
+            break;
+        }
+    }
+
+    return total;
+}
+
+uint32_t ring_readv(ring_buffer *ring, const io_vec *vec, uint32_t count, uint32_t len) {
+    uint32_t total = 0;
+
+    for (uint32_t i = 0; i < count && total < len; i++) {
+        uint32_t size = vec[i].size < len - total ? vec[i].size : len - total;
+        uint32_t read = ring_read(ring, vec[i].data, size);
+
+        total += read;
+
+        if (read < size) {
+            break;
+        }
+    }
+
+    return total;
+}
+
+int ring_put(ring_buffer *ring, uint8_t byte) {
+    uint32_t head = ring->head;
+
+    if (head - ring->tail > ring->mask) {
+        return -1;
+    }
+
+    ring->buffer[head & ring->mask] = byte;
+
+    RING_BARRIER();
+
+    ring->head = head + 1;
+
+    return 0;
+}
+
+int ring_get(ring_buffer *ring, uint8_t *byte) {
+    uint32_t tail = ring->tail;
+
+    if (ring->head == tail) {
+        return -1;
+    }
+
+    RING_BARRIER();
+
+    *byte = ring->buffer[tail & ring->mask];
+
+    RING_BARRIER();
+
+    ring->tail = tail + 1;
+
+    return 0;
+}
@@ -1,4 +1,5 @@
 #include "lib/string.h"
+#include "lib/format.h"
 #include "kernel/memory.h"
 
 int strncmp(const char *str1, const char *str2, int n) {
@@ -39,144 +40,23 @@ int strnlen(const char *str, uint32_t size) {
 
 int vsnprintf(char *buffer, unsigned int buffer_len,
     const char *fmt, va_list va) {
-    char *pbuffer = buffer;
-    char buf[STR_BUF_SIZE];
-    char ch;
+    fmt_buffer_sink sink;
 
-    int putc(char ch) {
-        if ((unsigned int)((pbuffer - buffer) + 1) >= buffer_len) {
-            return 0;
-        }
-        *(pbuffer++) = ch;
-        *(pbuffer) = '\0';
-        return 1;
-    }
+    fmt_buffer_sink_init(&sink, buffer, buffer_len);
 
-    int puts(char *s, unsigned int len) {
-        unsigned int i;
+    vformat(&sink.sink, fmt, va);
 
-        if (buffer_len - (pbuffer - buffer) - 1 < len) {
-            len = buffer_len - (pbuffer - buffer) - 1;
-        }
-
-        for (i = 0; i < len; i++) {
-            *(pbuffer++) = s[i];
-        }
-        *(pbuffer) = '\0';
-        return len;
-    }
-
-    while ((ch = *(fmt++))) {
-        if ((unsigned int)((pbuffer - buffer) + 1) >= buffer_len) {
-            break;
-        }
-        if (ch != '%') {
-            putc(ch);
-        } else {
-            char zero_pad = 0;
-            char *ptr;
-            unsigned int len;
-
-            ch = *(fmt++);
-
-            if (ch == '0') {
-                ch = *(fmt++);
-                if (ch == '\0') {
-                    goto end;
-                }
-                if (ch >= '0' && ch <= '9') {
-                    zero_pad = ch - '0';
-                }
-                ch = *(fmt++);
-            }
-
-            switch (ch) {
-                case 0:
-                    goto end;
-                case 'u':
-                case 'd':
-                    len = itoa(va_arg(va, unsigned int), 10, 0, (ch == 'u'),
-                        buf, zero_pad);
-                    puts(buf, len);
-                    break;
-                case 'x':
-                case 'X':
-                    len = itoa(va_arg(va, unsigned int), 16, (ch == 'X'), 1,
-                        buf, zero_pad);
-                    puts(buf, len);
-                    break;
-                case 'c' :
-                    putc((char)(va_arg(va, int)));
-                    break;
-                case 's' :
-                    ptr = va_arg(va, char*);
-                    puts(ptr, strlen(ptr));
-                    break;
-                default:
-                    putc(ch);
-                    break;
-            }
-        }
-    }
-    end:
-    return pbuffer - buffer;
+    return sink.pos ? sink.pos - buffer : 0;
 }
 
 void vfprintf(usart stdio, const char *fmt, va_list va) {
-    char buf[STR_BUF_SIZE];
-    char ch;
+    fmt_usart_sink sink;
 
     usart_iface *stdio_iface = usart_iface_get(stdio);
 
-    while ((ch = *(fmt++))) {
-        if (ch != '%') {
-            stdio_iface->putc(stdio_iface, ch);
-        } else {
-            char zero_pad = 0;
-            char *ptr;
-            unsigned int len;
-
-            ch = *(fmt++);
-
-            if (ch == '0') {
-                ch = *(fmt++);
-                if (ch == '\0') {
-                    return;
-                }
-                if (ch >= '0' && ch <= '9') {
-                    zero_pad = ch - '0';
-                }
-                ch = *(fmt++);
-            }
+    fmt_usart_sink_init(&sink, stdio_iface);
 
-            switch (ch) {
-                case 0:
-                    return;
-                case 'u':
-                case 'd':
-                    len = itoa(va_arg(va, unsigned int), 10, 0, (ch == 'u'),
-                        buf, zero_pad);
-                    stdio_iface->nputs(stdio_iface, buf, len);
-                    break;
-                case 'x':
-                case 'X':
-                    len = itoa(va_arg(va, unsigned int), 16, (ch == 'X'), 1,
-                        buf, zero_pad);
-                    stdio_iface->nputs(stdio_iface, buf, len);
-                    break;
-                case 'c' :
-                    stdio_iface->putc(stdio_iface, (char)(va_arg(va, int)));
-                    break;
-                case 's' :
-                    ptr = va_arg(va, char*);
-                    stdio_iface->nputs(stdio_iface, ptr, strlen(ptr));
-                    break;
-                default:
-                    stdio_iface->putc(stdio_iface, ch);
-                    break;
-            }
-        }
-    }
+    vformat(&sink.sink, fmt, va);
 }
 
 int snprintf(char *buffer, unsigned int buffer_len, const char *fmt, ...) {
@@ -386,6 +266,13 @@ void printf(const char *fmt, ...) {
     va_end(va);
 }
 
+void flush(void) {
+    usart_iface *stdio_iface = usart_iface_get(STDIO);
+    if (stdio_iface) {
+        stdio_iface->flush(stdio_iface);
+    }
+}
+
 char *strrchr(const char *s, char c) {
     char* ret = 0;
     do {
@@ -4,8 +4,6 @@
 #include "common/common.h"
 #include "platform/usart.h"
 
-#define STR_BUF_SIZE 24
-
 #define strsize(STR) (strlen(STR) + 1)
 
 /**
@@ -156,6 +154,11 @@ char *strcat(char *dst, const char *src);
  */
 void printf(const char *fmt, ...);
 
+/**
+ * @brief      wait until data queued to STDIO is transmitted
+ */
+void flush(void);
+
 char *strrchr(const char *s, char c);
 
 char *strchr(const char *s, char c);
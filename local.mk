@@ -2,6 +2,22 @@ CROSS_TOOL              ?= arm-none-eabi-
 
 TARGET                  ?= nucleo-stm32f401RE
 
+# per supervisor call counters ('syscalls' command), 1 to enable
+SVC_PROFILE             ?= 0
+
+# log messages up to level: 0 none, 1 error, 2 info, 3 debug, 4 trace
+LOG_LEVEL               ?= 4
+
+# emit raw log records (scripts/log_decode.py), 1 to enable
+LOG_BINARY              ?= 0
+
+# CRC kernels: 0 bitwise, 1 byte tables (768 B), 4 slice-by-4 (2.3 KiB),
+# no other values
+CRC_TABLES              ?= 4
+
+# SD card emulator and 'sdbench' command (debug only), 1 to enable
+SD_EMU                  ?= 0
+
 SERIAL_COMMUNICATION    ?= minicom -o -D
 
 SERIAL_DEVICE           ?= /dev/ttyACM0
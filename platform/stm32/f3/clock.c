@@ -1,6 +1,5 @@
 #include "platform/clock.h"
-
-extern volatile int32_t systick_msec;
+#include "arch/systick.h"
 
 /**
  * @brief      delay produced by forcing cpu doing nothing
@@ -12,12 +11,20 @@ static void dummy_dly(uint32_t dly) {
 }
 
 int32_t clock_get(void) {
-    return systick_msec;
+    //! single aligned word: no retry needed
+    return systick_page.msec;
+}
+
+uint32_t clock_get_us(void) {
+    uint32_t usec = 0;
+    int32_t  msec = systick_time_get(&usec);
+
+    return (uint32_t) msec * 1000 + usec;
 }
 
 void clock_dly_msecs(uint32_t msecs) {
-    int32_t timeout = systick_msec + msecs;
-    while (timeout - systick_msec > 0);
+    int32_t timeout = systick_page.msec + msecs;
+    while (timeout - systick_page.msec > 0);
 }
 
 void clock_dly_secs(uint32_t secs) {
@@ -1,9 +1,25 @@
+#include "arch/handler.h"
 #include "kernel/thread.h"
+#include "platform/handler.h"
+
+void handler_init(void) {
+    //! no peripheral of this platform is driven by DMA interrupts
+}
 
 void usart2_handler(void) {
     extern usart_iface *usart_iface_2;
-    if (usart_iface_2 && usart_iface_2->buffer_consume(usart_iface_2)) {
-        thread_signal(usart_iface_2);
-        sv_schedule_routine(NULL);
+    uint32_t start = isr_enter();
+
+    if (usart_iface_2) {
+        if (usart_iface_2->buffer_consume(usart_iface_2)) {
+            thread_signal(usart_iface_2);
+            sv_schedule_routine(NULL);
+        }
+
+        if (usart_iface_2->transmit(usart_iface_2)) {
+            sv_schedule_routine(NULL);
+        }
     }
+
+    isr_exit(ISR_USART, start);
 }
\ No newline at end of file
@@ -16,7 +16,7 @@ const void * Vectors[] __attribute__((section(".vectors"))) = {
     default_handler,     /* RESERVED */
     default_handler,     /* RESERVED */
     default_handler,     /* RESERVED */
-    sv_call_handler,     /* SVCall */
+    sv_call_entry,       /* SVCall */
     default_handler,     /* RESERVED */
     default_handler,     /* RESERVED */
     pend_sv_handler,     /* PendSV */
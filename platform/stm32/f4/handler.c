@@ -1,12 +1,46 @@
+#include "arch/handler.h"
 #include "kernel/thread.h"
 #include "platform/usart.h"
+#include "platform/spi_dma.h"
+#include "arch/nvic.h"
 
 extern void sv_schedule_routine(void*);
 
+void handler_init(void) {
+#ifdef HAS_SPI2
+    //! SPI2 RX DMA stream completes transfers
+    nvic_it_enable(IT_DMA1_CH4);
+#endif
+}
+
 void usart2_handler(void) {
     extern usart_iface *usart_iface_2;
-    if (usart_iface_2 && usart_iface_2->buffer_consume(usart_iface_2)) {
-        thread_signal(usart_iface_2);
+    uint32_t start = isr_enter();
+
+    if (usart_iface_2) {
+        if (usart_iface_2->buffer_consume(usart_iface_2)) {
+            thread_signal(usart_iface_2);
+            sv_schedule_routine(NULL);
+        }
+
+        if (usart_iface_2->transmit(usart_iface_2)) {
+            sv_schedule_routine(NULL);
+        }
+    }
+
+    isr_exit(ISR_USART, start);
+}
+
+void dma1_stream3_handler(void) {
+#ifdef HAS_SPI2
+    extern spi_iface *spi_iface_2;
+    uint32_t start = isr_enter();
+
+    if (spi_dma_complete(SPI2)) {
+        thread_signal(spi_iface_2);
         sv_schedule_routine(NULL);
     }
-}
\ No newline at end of file
+
+    isr_exit(ISR_SPI_DMA, start);
+#endif
+}
@@ -17,7 +17,7 @@ const void * Vectors[] __attribute__((section(".vectors"))) = {
     default_handler,     /* RESERVED */
     default_handler,     /* RESERVED */
     default_handler,     /* RESERVED */
-    sv_call_handler,     /* SVCall */
+    sv_call_entry,       /* SVCall */
     default_handler,     /* RESERVED */
     default_handler,     /* RESERVED */
     pend_sv_handler,     /* PendSV */
@@ -36,7 +36,7 @@ const void * Vectors[] __attribute__((section(".vectors"))) = {
     default_handler,     /* DMA_CH1 */
     default_handler,     /* DMA_CH2 */
     default_handler,     /* DMA_CH3 */
-    default_handler,     /* DMA_CH4 */
+    dma1_stream3_handler, /* DMA_CH4 */
     default_handler,     /* DMA_CH5 */
     default_handler,     /* DMA_CH6 */
     default_handler,     /* DMA_CH7 */
@@ -0,0 +1,15 @@
+#ifndef PLATFORM_SPI_DMA_H
+#define PLATFORM_SPI_DMA_H
+
+#include "platform/spi.h"
+
+/**
+ * @brief      finish DMA transfer, called from DMA stream interrupt
+ *
+ * @param[in]  spi_base  SPI base address
+ *
+ * @return     boolean value (waiting thread has to be signaled)
+ */
+int spi_dma_complete(spi spi_base);
+
+#endif
@@ -1,6 +1,28 @@
 #include "platform/spi.h"
+#include "platform/spi_dma.h"
+#include "arch/core.h"
 #include "kernel/syscall.h"
 
+//! shorter transfers are polled, DMA setup costs more than it saves
+#define SPI_DMA_MIN_LEN                     16
+
+//! DMA stream configuration bits
+#define DMA_SCR_EN                          BIT(0)
+#define DMA_SCR_TEIE                        BIT(2)
+#define DMA_SCR_TCIE                        BIT(4)
+#define DMA_SCR_DIR_M2P                     BIT(6)
+#define DMA_SCR_MINC                        BIT(10)
+#define DMA_SCR_PL_HIGH                     BIT(17)
+#define DMA_SCR_CHSEL(_ch)                  ((_ch) << 25)
+
+//! DMA stream interrupt flags (relative to stream flag offset)
+#define DMA_FLAG_TEIF                       BIT(3)
+#define DMA_FLAG_TCIF                       BIT(5)
+#define DMA_FLAG_ALL                        0x3d
+
+#define DMA1_STREAM(_n) \
+    ((dma_stream_regs *) (DMA1_BASE + 0x10 + 0x18 * (_n)))
+
 typedef struct spi_regs_t {
     uint32_t cr1;
     uint32_t cr2;
@@ -13,6 +35,33 @@ typedef struct spi_regs_t {
     uint32_t i2spr;
 } spi_regs;
 
+typedef struct dma_stream_regs_t {
+    uint32_t cr;
+    uint32_t ndtr;
+    uint32_t par;
+    uint32_t m0ar;
+    uint32_t m1ar;
+    uint32_t fcr;
+} dma_stream_regs;
+
+/**
+ * DMA1 streams serving SPI
+ */
+typedef struct spi_dma_t {
+    uint32_t   rx_stream;
+    uint32_t   tx_stream;
+    uint32_t   channel;
+} spi_dma;
+
+#ifdef HAS_SPI2
+//! RM0368: SPI2_RX - DMA1 stream 3, SPI2_TX - DMA1 stream 4, channel 0
+static const spi_dma spi2_dma = {
+    .rx_stream = 3,
+    .tx_stream = 4,
+    .channel   = 0,
+};
+#endif
+
 #ifdef HAS_SPI1
     spi_iface *spi_iface_1 = NULL;
 #endif
@@ -41,6 +90,17 @@ typedef struct spi_ctx_t {
     uint32_t mosi_pin;
 
     spi_regs   *regs;
+
+    /**
+     * DMA streams, NULL - transfers are polled
+     */
+    const spi_dma     *dma;
+    volatile uint32_t  dma_done;
+    uint32_t           dma_error;
+    //! transmitted while receiving
+    uint8_t            dma_fill;
+    //! received while transmitting
+    uint8_t            dma_sink;
 } spi_ctx;
 
 /**
@@ -92,12 +152,133 @@ static void spi_set_prescaler(spi_iface *iface, spi_prescaler prescaler) {
     ctx->regs->cr1 |= ((uint8_t)prescaler << 3);
 }
 
+static inline
+uint32_t dma_flag_shift(uint32_t stream) {
+    static const uint8_t shift[4] = {0, 6, 16, 22};
+
+    return shift[stream & 0x03];
+}
+
+static uint32_t dma_flags_get(uint32_t stream) {
+    uint32_t isr = stream < 4 ? DMA1_LISR : DMA1_HISR;
+
+    return (isr >> dma_flag_shift(stream)) & DMA_FLAG_ALL;
+}
+
+static void dma_flags_clear(uint32_t stream) {
+    if (stream < 4) {
+        DMA1_LIFCR = DMA_FLAG_ALL << dma_flag_shift(stream);
+    } else {
+        DMA1_HIFCR = DMA_FLAG_ALL << dma_flag_shift(stream);
+    }
+}
+
+/**
+ * @brief      program DMA stream, stream is left disabled
+ *
+ * @param[in]  stream  stream number
+ * @param[in]  cr      stream configuration
+ * @param      periph  peripheral data register
+ * @param      mem     memory address
+ * @param[in]  len     number of bytes
+ */
+static void dma_stream_setup(uint32_t stream, uint32_t cr,
+    volatile uint32_t *periph, const void *mem, uint32_t len) {
+    dma_stream_regs *regs = DMA1_STREAM(stream);
+
+    regs->cr &= ~DMA_SCR_EN;
+    while (regs->cr & DMA_SCR_EN);
+
+    dma_flags_clear(stream);
+
+    regs->par  = (uint32_t) periph;
+    regs->m0ar = (uint32_t) mem;
+    regs->ndtr = len;
+    //! direct mode, byte sized on both sides
+    regs->fcr  = 0;
+    regs->cr   = cr;
+}
+
+/**
+ * @brief      transfer buffer with DMA, caller sleeps until RX stream is done
+ *
+ * @return     0 on success
+ */
+static int spi_dma_transfer(spi_ctx *ctx, const uint8_t *tx_buf, uint8_t *rx_buf,
+    uint32_t len) {
+    const spi_dma *dma = ctx->dma;
+    uint32_t base = DMA_SCR_CHSEL(dma->channel) | DMA_SCR_PL_HIGH;
+
+    ctx->dma_done  = 0;
+    ctx->dma_error = 0;
+    ctx->dma_fill  = 0xff;
+
+    dma_stream_setup(dma->rx_stream,
+        base | DMA_SCR_TCIE | DMA_SCR_TEIE | (rx_buf ? DMA_SCR_MINC : 0),
+        &ctx->regs->dr, rx_buf ? rx_buf : &ctx->dma_sink, len);
+    dma_stream_setup(dma->tx_stream,
+        base | DMA_SCR_DIR_M2P | (tx_buf ? DMA_SCR_MINC : 0),
+        &ctx->regs->dr, tx_buf ? tx_buf : &ctx->dma_fill, len);
+
+    //! RX request first so that no received byte is missed
+    ctx->regs->cr2 |= BIT(0);
+
+    DMA1_STREAM(dma->rx_stream)->cr |= DMA_SCR_EN;
+    DMA1_STREAM(dma->tx_stream)->cr |= DMA_SCR_EN;
+
+    //! TX request starts clocking
+    ctx->regs->cr2 |= BIT(1);
+
+    while (!ctx->dma_done) {
+        wait_cond(ctx, &ctx->dma_done, 0);
+    }
+
+    ctx->regs->cr2 &= ~(BIT(1) | BIT(0));
+
+    return ctx->dma_error ? -2 : 0;
+}
+
+int spi_dma_complete(spi spi_base) {
+    spi_iface **iface_ptr = spi_base_to_iface(spi_base);
+    if (!iface_ptr || !*iface_ptr) {
+        return 0;
+    }
+
+    spi_ctx       *ctx = (spi_ctx*) *iface_ptr;
+    const spi_dma *dma = ctx->dma;
+    if (!dma) {
+        return 0;
+    }
+
+    uint32_t flags = dma_flags_get(dma->rx_stream);
+
+    dma_flags_clear(dma->rx_stream);
+
+    if (!(flags & (DMA_FLAG_TCIF | DMA_FLAG_TEIF))) {
+        return 0;
+    }
+
+    DMA1_STREAM(dma->rx_stream)->cr &= ~DMA_SCR_EN;
+    DMA1_STREAM(dma->tx_stream)->cr &= ~DMA_SCR_EN;
+    dma_flags_clear(dma->tx_stream);
+
+    ctx->dma_error = flags & DMA_FLAG_TEIF;
+    ctx->dma_done  = 1;
+
+    return 1;
+}
+
 static int spi_transmit_receive(spi_iface *iface, const uint8_t *tx_buf, uint8_t *rx_buf, uint32_t len) {
     spi_ctx *ctx = (spi_ctx*) iface;
     if (!ctx) {
         return -1;
     }
 
+    //! kernel and handlers can't sleep, they keep polling
+    if (ctx->dma && len >= SPI_DMA_MIN_LEN && !core_privileged()) {
+        return spi_dma_transfer(ctx, tx_buf, rx_buf, len);
+    }
+
     while (len) {
         while (!transmitter_available(ctx));
         ctx->regs->dr = tx_buf ? *tx_buf++ : 0xff;
@@ -222,6 +403,7 @@ static spi_iface *spi_iface_create(spi spi_base) {
 
     //! set register base address
     ctx->regs = (spi_regs*) spi_base;
+    ctx->dma  = NULL;
 
     switch (spi_base) {
 #ifdef HAS_SPI1
@@ -232,6 +414,11 @@ static spi_iface *spi_iface_create(spi spi_base) {
 #ifdef HAS_SPI2
         case SPI2:
             RCC_APB1ENR |= BIT(14);
+            //! DMA1 clock
+            RCC_AHB1ENR |= BIT(21);
+            //! stream interrupt is enabled by handler_init, NVIC isn't
+            //! accessible from user threads
+            ctx->dma = &spi2_dma;
             break;
 #endif
 #ifdef HAS_SPI3
@@ -3,6 +3,8 @@
 #include "arch/nvic.h"
 #include "kernel/memory.h"
 #include "kernel/syscall.h"
+#include "kernel/thread.h"
+#include "lib/ring.h"
 
 typedef struct usart_regs_t {
     uint32_t sr;
@@ -45,6 +47,15 @@ typedef struct usart_ctx_t {
     uint32_t    buffer_size;
     int         buffer_locked;
 
+    ring_buffer rx_ring;
+
+    ring_buffer tx_ring;
+    //! serializes writer threads (ring has a single producer)
+    volatile uint32_t tx_lock;
+    volatile int      tx_contended;
+    //! writer is blocked on full ring
+    volatile int      tx_waiting;
+
     usart_regs   *regs;
 } usart_ctx;
 
@@ -99,6 +110,14 @@ static void usart_destroy(usart_iface *iface) {
         cell_free((*ctx)->buffer);
     }
 
+    if ((*ctx)->rx_ring.buffer) {
+        cell_free((*ctx)->rx_ring.buffer);
+    }
+
+    if ((*ctx)->tx_ring.buffer) {
+        cell_free((*ctx)->tx_ring.buffer);
+    }
+
     *ctx = NULL;
 }
 
@@ -130,6 +149,26 @@ static int usart_iface_init(usart_iface *iface, const usart_config *config) {
     ctx->buffer_idx   = 0;
     ctx->buffer_locked = 0;
 
+    uint32_t ring_size = ring_size_round_up(config->buffer_size);
+
+    uint8_t *ring_buf = cell_alloc(ring_size);
+    if (!ring_buf) {
+        return 0;
+    }
+
+    ring_init(&ctx->rx_ring, ring_buf, ring_size);
+
+    if (config->tx_buffer_size) {
+        ring_size = ring_size_round_up(config->tx_buffer_size);
+
+        ring_buf = cell_alloc(ring_size);
+        if (!ring_buf) {
+            return 0;
+        }
+
+        ring_init(&ctx->tx_ring, ring_buf, ring_size);
+    }
+
     ctx->io_iface = gpio_iface_get(config->port);
     if (!ctx->io_iface) {
         return 0;
@@ -208,6 +247,150 @@ static int usart_transmitter_available(usart_ctx *ctx) {
     return (ctx->regs->sr & BIT(7));
 }
 
+/**
+ * @brief      put a single charater to usart transmitter by polling
+ *
+ * @param      ctx   usart context
+ * @param[in]  data  character to send
+ */
+static void usart_poll_putc(usart_ctx *ctx, char data) {
+    while (!usart_transmitter_available(ctx));
+
+    ctx->regs->dr = data;
+}
+
+/**
+ * @brief      enable/disable TXE interrupt
+ *
+ * @param      ctx     usart context
+ * @param[in]  enable  enable flag
+ */
+static void usart_tx_irq(usart_ctx *ctx, int enable) {
+    if (enable) {
+        ctx->regs->cr1 |= BIT(7);
+    } else {
+        ctx->regs->cr1 &= ~BIT(7);
+    }
+}
+
+/**
+ * @brief      move transmit ring to transmitter by polling
+ *
+ * NOTE: takes consumer side from TXE interrupt, privileged code only
+ *
+ * @param      ctx    usart context
+ * @param[in]  count  bytes to move at most
+ */
+static void usart_tx_poll_drain(usart_ctx *ctx, uint32_t count) {
+    uint32_t primask = core_irq_save();
+    uint8_t  byte;
+
+    while (count-- && !ring_get(&ctx->tx_ring, &byte)) {
+        usart_poll_putc(ctx, byte);
+    }
+
+    core_irq_restore(primask);
+}
+
+/**
+ * @brief      block writer thread until transmitter makes room in ring
+ *
+ * @param      ctx   usart context
+ */
+static void usart_tx_wait(usart_ctx *ctx) {
+    uint32_t tail = ctx->tx_ring.tail;
+
+    ctx->tx_waiting = 1;
+
+    usart_tx_irq(ctx, 1);
+
+    //! sleep unless transmitter moved on after tail was sampled
+    wait_cond(&ctx->tx_ring, &ctx->tx_ring.tail, tail);
+}
+
+/**
+ * @brief      take transmit ring producer side
+ *
+ * @param      ctx   usart context
+ *
+ * @return     boolean value (0 - transmit by polling)
+ */
+static int usart_tx_lock(usart_ctx *ctx) {
+    if (!ctx->tx_ring.buffer) {
+        return 0;
+    }
+
+    while (__sync_lock_test_and_set(&ctx->tx_lock, 1)) {
+        //! owner is preempted by us, can't wait for it
+        if (core_privileged()) {
+            return 0;
+        }
+
+        ctx->tx_contended = 1;
+
+        wait_cond((const void *) &ctx->tx_lock, &ctx->tx_lock, 1);
+    }
+
+    return 1;
+}
+
+/**
+ * @brief      release transmit ring producer side and start transmitter
+ *
+ * @param      ctx   usart context
+ */
+static void usart_tx_unlock(usart_ctx *ctx) {
+    usart_tx_irq(ctx, 1);
+
+    __sync_lock_release(&ctx->tx_lock);
+
+    if (ctx->tx_contended) {
+        ctx->tx_contended = 0;
+
+        if (core_privileged()) {
+            thread_signal((const void *) &ctx->tx_lock);
+        } else {
+            signal((const void *) &ctx->tx_lock);
+        }
+    }
+}
+
+/**
+ * @brief      queue a single character (producer side is locked)
+ *
+ * @param      ctx   usart context
+ * @param[in]  data  character to send
+ */
+static void usart_tx_put(usart_ctx *ctx, char data) {
+    while (ring_put(&ctx->tx_ring, data)) {
+        if (core_privileged()) {
+            //! can't block: make room by feeding transmitter directly
+            usart_tx_poll_drain(ctx, 1);
+        } else {
+            usart_tx_wait(ctx);
+        }
+    }
+}
+
+/**
+ * @brief      send a single character (queued or polled)
+ *
+ * @param      ctx     usart context
+ * @param[in]  data    character to send
+ * @param[in]  queued  transmit ring producer side is locked
+ */
+static void usart_tx_char(usart_ctx *ctx, char data, int queued) {
+    if (queued) {
+        usart_tx_put(ctx, data);
+    } else {
+        usart_poll_putc(ctx, data);
+    }
+
+    if (data == '\n') {
+        usart_tx_char(ctx, '\r', queued);
+    }
+}
+
 /**
  * @brief      put a single charater to usart transmitter
  *
@@ -217,12 +400,12 @@ static int usart_transmitter_available(usart_ctx *ctx) {
 static void usart_putc(usart_iface *iface, char data) {
     usart_ctx *ctx = (usart_ctx*) iface;
 
-    while (!usart_transmitter_available(ctx));
+    int queued = usart_tx_lock(ctx);
 
-    ctx->regs->dr = data;
+    usart_tx_char(ctx, data, queued);
 
-    if (data == '\n') {
-        usart_putc(iface, '\r');
+    if (queued) {
+        usart_tx_unlock(ctx);
     }
 }
 
@@ -234,12 +417,19 @@ static void usart_putc(usart_iface *iface, char data) {
  * @param[in]  len    string length
  */
 static void usart_nputs(usart_iface *iface, const char *data, uint32_t len) {
+    usart_ctx *ctx = (usart_ctx*) iface;
     char *data_ptr = (char*) data;
 
+    int queued = usart_tx_lock(ctx);
+
     while (*data_ptr && len--) {
-        usart_putc(iface, *data_ptr);
+        usart_tx_char(ctx, *data_ptr, queued);
         data_ptr++;
     }
+
+    if (queued) {
+        usart_tx_unlock(ctx);
+    }
 }
 
 /**
@@ -249,12 +439,7 @@ static void usart_nputs(usart_iface *iface, const char *data, uint32_t len) {
  * @param[in]  data   string ptr
  */
 static void usart_puts(usart_iface *iface, const char *data) {
-    char *data_ptr = (char*) data;
-
-    while (*data_ptr) {
-        usart_putc(iface, *data_ptr);
-        data_ptr++;
-    }
+    usart_nputs(iface, data, (uint32_t) -1);
 }
 
 /**
@@ -293,7 +478,39 @@ static char *usart_buffer_drain(usart_iface *iface) {
     usart_ctx *ctx = (usart_ctx*) iface;
 
     while (!ctx->buffer_locked) {
-        wait(iface);
+        uint8_t input;
+
+        uint32_t head = ctx->rx_ring.head;
+
+        if (ring_get(&ctx->rx_ring, &input)) {
+            //! sleep unless the handler queued input after head was sampled
+            wait_cond(iface, &ctx->rx_ring.head, head);
+            continue;
+        }
+
+        if (ctx->buffer_idx >= ctx->buffer_size) {
+            ctx->buffer_idx = 0;
+        }
+
+        switch (input) {
+            case '\b':
+                if (ctx->buffer_idx > 0) {
+                    ctx->buffer_idx--;
+                    usart_puts(iface, "\b \b");
+                }
+                break;
+            case '\r':
+                usart_puts(iface, "\r\n");
+                ctx->buffer_locked = 1;
+                //! drop type-ahead, as before
+                ring_reset(&ctx->rx_ring);
+                break;
+            default:
+                ctx->buffer[ctx->buffer_idx] = input;
+                usart_putc(iface, input);
+                ctx->buffer_idx++;
+                break;
+        }
     }
 
     //! set null string terminator
@@ -305,7 +522,9 @@ static char *usart_buffer_drain(usart_iface *iface) {
 }
 
 /**
- * @brief      fill usart receiver buffer with incomming data
+ * @brief      queue incomming data to usart receiver ring
+ *
+ * NOTE: line discipline and echo are done by reader (usart_buffer_drain)
  *
  * @param      iface  usart interface
  */
@@ -321,33 +540,71 @@ static int usart_buffer_consume(usart_iface *iface) {
             continue;
         }
 
-        if (ctx->buffer_idx >= ctx->buffer_size) {
-            ctx->buffer_idx = 0;
-        }
-
-        switch (input) {
-            case '\b':
-                if (ctx->buffer_idx > 0) {
-                    ctx->buffer_idx--;
-                    usart_puts(iface, "\b \b");
-                }
-                break;
-            case '\r':
-                usart_puts(iface, "\r\n");
-                ctx->buffer_locked = 1;
-                ready = 1;
-                break;
-            default:
-                ctx->buffer[ctx->buffer_idx] = input;
-                usart_putc(iface, input);
-                ctx->buffer_idx++;
-                break;
+        if (!ring_put(&ctx->rx_ring, input)) {
+            ready = 1;
         }
     }
 
     return ready;
 }
 
+/**
+ * @brief      feed transmitter from usart transmit ring
+ *
+ * @param      iface  usart interface
+ *
+ * @return     boolean value (blocked writers were signaled)
+ */
+static int usart_transmit(usart_iface *iface) {
+    usart_ctx *ctx = (usart_ctx*) iface;
+
+    if (!(ctx->regs->cr1 & BIT(7)) || !usart_transmitter_available(ctx)) {
+        return 0;
+    }
+
+    uint8_t byte;
+
+    if (ring_get(&ctx->tx_ring, &byte)) {
+        usart_tx_irq(ctx, 0);
+    } else {
+        ctx->regs->dr = byte;
+    }
+
+    //! wake writers once half of the ring is free (or when it is empty)
+    if (ctx->tx_waiting &&
+        ring_used(&ctx->tx_ring) <= ring_size(&ctx->tx_ring) / 2) {
+        ctx->tx_waiting = 0;
+
+        thread_signal(&ctx->tx_ring);
+
+        return 1;
+    }
+
+    return 0;
+}
+
+/**
+ * @brief      wait until all queued data is transmitted
+ *
+ * @param      iface  usart interface
+ */
+static void usart_flush(usart_iface *iface) {
+    usart_ctx *ctx = (usart_ctx*) iface;
+
+    if (!ctx->tx_ring.buffer) {
+        return;
+    }
+
+    if (core_privileged()) {
+        usart_tx_poll_drain(ctx, ring_size(&ctx->tx_ring));
+        return;
+    }
+
+    while (ring_used(&ctx->tx_ring)) {
+        usart_tx_wait(ctx);
+    }
+}
+
 /**
  * @brief      allocate usart context and initialize interface pointers
  *
@@ -367,6 +624,8 @@ static usart_iface *usart_iface_create(usart usart_base) {
     iface->nputs             = usart_nputs;
     iface->buffer_drain      = usart_buffer_drain;
     iface->buffer_consume    = usart_buffer_consume;
+    iface->transmit          = usart_transmit;
+    iface->flush             = usart_flush;
     iface->buffer_locked     = usart_buffer_locked;
     iface->set_buffer_locked = usart_set_buffer_locked;
     iface->destroy           = usart_destroy;
@@ -377,6 +636,14 @@ static usart_iface *usart_iface_create(usart usart_base) {
 
     ctx->buffer = NULL;
     ctx->io_iface = NULL;
+    //! rings are set up by init, destroy may run before that; TX ring
+    //! stays unset for polled output
+    ctx->rx_ring.buffer = NULL;
+    ctx->tx_ring.buffer = NULL;
+
+    ctx->tx_lock      = 0;
+    ctx->tx_contended = 0;
+    ctx->tx_waiting   = 0;
 
     switch (usart_base) {
 #ifdef HAS_USART1
@@ -11,6 +11,16 @@
  */
 int32_t clock_get(void);
 
+/**
+ * @brief      gets time in microseconds (wraps in ~71 minutes)
+ *
+ * NOTE: microsecond resolution in privileged mode only, user threads
+ *       get milliseconds scaled
+ *
+ * @return     microseconds since boot
+ */
+uint32_t clock_get_us(void);
+
 /**
  * @brief      delay in mseconds
  *
@@ -1,6 +1,14 @@
 #ifndef PLATFORM_HANDLER_H
 #define PLATFORM_HANDLER_H
 
+/**
+ * @brief      enable interrupts of peripherals driven from user threads
+ *
+ * NOTE: called once from privileged init, drivers running in user
+ *       threads can't access NVIC
+ */
+void handler_init(void);
+
 /**
  * @defgroup USART_INTERRUPTS usart/uart interrupt routines
  *
@@ -11,4 +19,14 @@ void usart2_handler(void);
 
 /** @} */
 
+/**
+ * @defgroup DMA_INTERRUPTS DMA stream interrupt routines
+ *
+ * @{
+ */
+
+void dma1_stream3_handler(void);
+
+/** @} */
+
 #endif
\ No newline at end of file
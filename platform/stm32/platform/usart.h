@@ -67,13 +67,30 @@ typedef struct usart_iface_t {
      */
     char* (*buffer_drain)(struct usart_iface_t *iface);
     /**
-     * @brief      fill usart receiver buffer with incomming data
+     * @brief      queue incomming data to usart receiver ring (ISR side)
      *
      * @param      iface  usart interface
      *
-     * @return     boolean value (ready to be processed)
+     * @return     boolean value (new data queued for the reader)
      */
     int  (*buffer_consume)(struct usart_iface_t *iface);
+    /**
+     * @brief      feed transmitter from usart transmit ring (ISR side)
+     *
+     * @param      iface  usart interface
+     *
+     * @return     boolean value (blocked writers were signaled)
+     */
+    int  (*transmit)(struct usart_iface_t *iface);
+    /**
+     * @brief      wait until all queued data is transmitted
+     *
+     * NOTE: in handler mode ring is drained by polling, so it is safe to
+     *       use from fault handlers
+     *
+     * @param      iface  usart interface
+     */
+    void  (*flush)(struct usart_iface_t *iface);
     /**
      * @brief      check if transfer to usart buffer locked
      *
@@ -98,6 +115,10 @@ typedef struct usart_iface_t {
 typedef struct usart_config_t {
     uint32_t  baud_rate;
     uint32_t  buffer_size;
+    /**
+     * transmit ring size (0 - blocking transmit by polling)
+     */
+    uint32_t  tx_buffer_size;
 
     gpio_port port;
     uint32_t tx_pin;
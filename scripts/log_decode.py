@@ -0,0 +1,135 @@
+#!/usr/bin/env python3
+"""
+Decode raw log records (LOG_BINARY=1 build) using firmware ELF image.
+
+Record line: '#' site time args... (32 bit hex words), all other lines are
+passed through unchanged.
+
+usage: log_decode.py <firmware.elf> [log file, default: stdin]
+"""
+
+import re
+import struct
+import sys
+
+TAGS = ["", "[ERROR]", "[INFO] ", "[DEBUG]", "[TRACE]"]
+
+SHT_PROGBITS = 1
+SHF_ALLOC = 0x2
+
+
+class Image:
+    """loadable sections of 32 bit little endian ELF"""
+
+    def __init__(self, path):
+        with open(path, "rb") as f:
+            data = f.read()
+
+        if data[:4] != b"\x7fELF" or data[4] != 1 or data[5] != 1:
+            raise ValueError("32 bit little endian ELF expected")
+
+        shoff, = struct.unpack_from("<I", data, 0x20)
+        shentsize, shnum = struct.unpack_from("<HH", data, 0x2e)
+
+        self.sections = []
+        for i in range(shnum):
+            (_, sh_type, flags, addr, offset, size) = \
+                struct.unpack_from("<IIIIII", data, shoff + i * shentsize)
+            if sh_type == SHT_PROGBITS and flags & SHF_ALLOC and size:
+                self.sections.append((addr, data[offset:offset + size]))
+
+    def read(self, addr, size):
+        for base, blob in self.sections:
+            if base <= addr and addr + size <= base + len(blob):
+                return blob[addr - base:addr - base + size]
+        raise KeyError(hex(addr))
+
+    def u32(self, addr):
+        return struct.unpack("<I", self.read(addr, 4))[0]
+
+    def string(self, addr):
+        out = bytearray()
+        while True:
+            ch = self.read(addr + len(out), 1)
+            if ch == b"\0":
+                return out.decode("ascii", "replace")
+            out += ch
+
+
+def to_signed(value):
+    return value - (1 << 32) if value & 0x80000000 else value
+
+
+def format_message(fmt, args):
+    """mirror of firmware vformat conversions: %[0][width]{d,u,x,X,c,s}"""
+    args = list(args)
+
+    def conv(match):
+        zero, width, spec = match.group(1), match.group(2), match.group(3)
+        if not spec:
+            # '%' at the end of format is dropped
+            return ""
+        if spec in "duxXcs":
+            value = args.pop(0) if args else 0
+        if spec == "d":
+            text = str(to_signed(value))
+        elif spec == "u":
+            text = str(value)
+        elif spec == "x":
+            text = "%x" % value
+        elif spec == "X":
+            text = "%X" % value
+        elif spec == "c":
+            text = chr(value & 0xff)
+        elif spec == "s":
+            # string lives in RAM, not available on host
+            text = "<0x%08x>" % value
+        else:
+            # any other character is put as is ("%%" gives '%')
+            text = spec
+        width = int(width) if width else 0
+        if len(text) >= width:
+            return text
+        if zero and spec == "d" and text.startswith("-"):
+            # sign goes before zeros
+            return "-" + text[1:].rjust(width - 1, "0")
+        return text.rjust(width, "0" if zero else " ")
+
+    return re.sub(r"%(0?)(\d*)(.?)", conv, fmt, flags=re.DOTALL)
+
+
+def decode(image, line):
+    words = [int(line[i:i + 8], 16) for i in range(1, len(line) - 7, 8)]
+    site, time, args = words[0], words[1], words[2:]
+
+    fmt, file, func = (image.string(image.u32(site + i * 4)) for i in range(3))
+    line_no, level, nargs = struct.unpack("<HBB", image.read(site + 12, 4))
+
+    text = "%s %s::%s():%d" % (TAGS[level] if level < len(TAGS) else "",
+                               file, func, line_no)
+    if fmt:
+        text += " " + format_message(fmt, args[:nargs])
+
+    return "%d %s" % (to_signed(time), text.rstrip("\n"))
+
+
+def main():
+    if len(sys.argv) < 2:
+        sys.exit(__doc__.strip())
+
+    image = Image(sys.argv[1])
+    stream = open(sys.argv[2], errors="replace") if len(sys.argv) > 2 \
+        else sys.stdin
+
+    for raw in stream:
+        line = raw.strip("\r\n")
+        if re.fullmatch(r"#(?:[0-9a-f]{8}){2,}", line):
+            try:
+                line = decode(image, line)
+            except (KeyError, IndexError, UnicodeDecodeError):
+                pass
+        print(line, flush=True)
+
+
+if __name__ == "__main__":
+    main()
@@ -30,6 +30,18 @@ CC_FLAGS                := -mcpu=cortex-$(CORE) -mthumb -g -ffreestanding \
                            -std=gnu99 -fomit-frame-pointer -Werror \
                            -Wall -Wextra -mfloat-abi=hard -mapcs-frame \
                            -mlittle-endian
+ifeq ($(SVC_PROFILE),1)
+CC_FLAGS                += -DSVC_PROFILE
+endif
+CC_FLAGS                += -DLOG_LEVEL=$(LOG_LEVEL)
+CC_FLAGS                += -DCRC_TABLES=$(CRC_TABLES)
+ifeq ($(LOG_BINARY),1)
+CC_FLAGS                += -DLOG_BINARY
+endif
+ifeq ($(SD_EMU),1)
+CC_FLAGS                += -DSD_EMU
+endif
+
 LD_FLAGS                := -T $(LD_SCRIPT) --cref \
                            -Map $(PROJECT_MAP)
 
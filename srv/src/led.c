@@ -40,7 +40,7 @@ static void led_init(void) {
 void led_loop(void) {
     led_init();
 
-    int ret = socket(LED_PORT);
+    int ret = socket(LED_PORT, SOCKET_DGRAM);
     ASSERT(!ret);
 
     while (1) {
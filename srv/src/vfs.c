@@ -10,6 +10,10 @@
 #include "platform/spi.h"
 #include "driver/sd_spi.h"
 #include "app/terminal.h"
+#include "kernel/mutex.h"
+#include "kernel/ted.h"
+#include "kernel/thread.h"
+#include "common/utils.h"
 
 #define VFS_CONNECTIONS_MAX        0x08
 
@@ -17,28 +21,89 @@
 
 #define VFS_REPL_BUFFER_SIZE       (sizeof(vfs_reply) + VFS_BUF_MAX)
 
+#define VFS_SESSIONS_MAX           0x04
+
+//! server closes session connection after this period of silence
+#define VFS_SESSION_IDLE_MS        5000
+
+#define VFS_REPLY_TIMEOUT_MS       100
+
+#define VFS_SQ_SIZE                0x04
+
+//! initial cache block size, switched to filesystem block size on mount
+#define VFS_BCACHE_BLOCK_SIZE      0x400
+
+#define VFS_BCACHE_SLOTS           0x08
+
+//! cache blocks kept loaded ahead of sequential reader
+#define VFS_READAHEAD_BLOCKS       0x04
+
+//! one more read-ahead slot keeps block being read while next are loaded
+#define VFS_BCACHE_AHEAD_SLOTS     (VFS_READAHEAD_BLOCKS + 1)
+
+//! directories kept loaded besides root, least recently used are dropped
+#define VFS_DIRS_LOADED_MAX        0x08
+
 typedef int (*vfs_handler)(const void *conn, vfs_command *command, file_desc *root, fs_ifc *fs);
 
 typedef struct vfs_fd_t {
     int        fd;
     file_desc *file;
     uint32_t   fpos;
+    //! reads so far (saturating)
+    uint8_t    seq_reads;
+    //! read-ahead is due, issued when server is idle
+    uint8_t    ra_pending;
+    //! file data up to this offset is requested from cache
+    uint32_t   ra_end;
 } vfs_fd;
 
-typedef struct vfs_rw_req_t {
-    int      fd;
-    uint32_t size;
-    char     buf[];
-} vfs_rw_req;
+typedef struct vfs_dir_t {
+    file_desc *dir;
+    //! last access, least recently used directory is dropped first
+    uint32_t   stamp;
+} vfs_dir;
 
-typedef struct vfs_fd_req_t {
-    int fd;
-} vfs_fd_req;
+typedef struct vfs_session_t {
+    const void *thread;
+    const void *conn;
+    uint16_t    next_id;
+} vfs_session;
+
+typedef struct vfs_conn_t {
+    const void *conn;
+    int32_t     last_active;
+} vfs_conn;
 
 static list_ifc *open_fd = NULL;
 
+//! directories loaded on access (vfs_dir), root isn't tracked
+static list_ifc *loaded_dir = NULL;
+
+static uint32_t  dir_clock = 0;
+
+//! server side list of session connections (vfs_conn)
+static list_ifc *open_conn = NULL;
+
+//! client side sessions (one per thread)
+static vfs_session sessions[VFS_SESSIONS_MAX];
+
+static uint32_t    session_evict = 0;
+
+static mutex       session_lock;
+
+/**
+ * bumped when a client takes a reply off its ring or a reply wait times
+ * out, server waiting for ring space (vfs_send_reply) watches it
+ */
+static volatile uint32_t reply_events  = 0;
+
+static volatile uint32_t reply_blocked = 0;
+
 static int current_fd = 0;
 
+static bcache *disk_cache = NULL;
+
 static const spi_config cfg = {
     .prescaler = SPI_PRESCALER_2,
     .mode      = SPI_MODE_MASTER,
@@ -77,30 +142,59 @@ static inline int gen_fd(void) {
     return current_fd;
 }
 
-static int vfs_send_reply(const void *conn, int ret_code, const char *reply_buf, uint32_t buf_sz) {
-    vfs_reply * reply = malloc(sizeof(vfs_reply) + buf_sz);
-    if (!reply) {
+/**
+ * @brief      wake server waiting for ring space (SysTick context)
+ */
+static void vfs_reply_timeout(void *ctx) {
+    (*(volatile uint32_t *) ctx)++;
+    thread_signal(ctx);
+}
+
+static int vfs_send_reply(const void *conn, const vfs_command *command, int ret_code,
+    const char *reply_buf, uint32_t buf_sz) {
+    vfs_reply reply = {
+        .ret = ret_code,
+        .id  = command->id,
+    };
+
+    io_vec vec[] = {
+        {.data = &reply,           .size = sizeof(vfs_reply)},
+        {.data = (void *) reply_buf, .size = buf_sz},
+    };
+
+    int ret = writev(conn, vec, buf_sz ? 2 : 1);
+    if (ret) {
+        return ret > 0 ? ret : -1;
+    }
+
+    //! datagram is queued as a whole once the client drains its ring,
+    //! client that stopped reading must not stall the server
+    ted_timer timer;
+    ted_timer_init(&timer, vfs_reply_timeout, (void *) &reply_events);
+    if (timer_start(&timer, VFS_REPLY_TIMEOUT_MS, 0)) {
         return -1;
     }
 
-    reply->ret = ret_code;
+    int32_t deadline = clock_get() + VFS_REPLY_TIMEOUT_MS;
+
+    reply_blocked = 1;
+
+    while (1) {
+        uint32_t events = reply_events;
+
+        ret = writev(conn, vec, buf_sz ? 2 : 1);
+        if (ret || clock_get() - deadline >= 0) {
+            break;
+        }
 
-    if (buf_sz) {
-        memcpy(reply->buf, reply_buf, buf_sz);
+        wait_cond((const void *) &reply_events, &reply_events, events);
     }
 
-    int ret = 0;
-    uint32_t offset = 0;
-    char *buf = (void *) reply;
-    do {
-        ret =  write(conn, buf + offset, sizeof(vfs_reply) + buf_sz - offset);
-        offset += ret;
-        sleep(1);
-    } while (ret >= 0 && offset < sizeof(vfs_reply) + buf_sz);
+    reply_blocked = 0;
 
-    free(reply);
+    timer_cancel(&timer);
 
-    return ret;
+    return ret > 0 ? ret : -1;
 }
 
 static const list_node *fd_get(int fd) {
@@ -131,7 +225,136 @@ static const list_node *fd_get_by_desc(file_desc *file) {
     return NULL;
 }
 
-static file_desc *resolve_helper(list_ifc *entries, file_desc *root) {
+/**
+ * @return     boolean value (directory or one of its entries is open)
+ */
+static int dir_is_open(file_desc *dir) {
+    const list_node *node = open_fd->get_front(open_fd);
+    while (node) {
+        vfs_fd *fd = node->ptr;
+        if (fd->file == dir) {
+            return 1;
+        }
+
+        const list_node *dirent = dir->child->get_front(dir->child);
+        while (dirent) {
+            if (fd->file == dirent->ptr) {
+                return 1;
+            }
+
+            dirent = dirent->nxt;
+        }
+
+        node = node->nxt;
+    }
+
+    return 0;
+}
+
+/**
+ * @return     boolean value (some subdirectory of directory is loaded)
+ */
+static int dir_has_loaded(file_desc *dir) {
+    const list_node *dirent = dir->child->get_front(dir->child);
+    while (dirent) {
+        file_desc *desc = dirent->ptr;
+        if (desc->type == F_TYPE_DIR && !desc->link && desc->child) {
+            return 1;
+        }
+
+        dirent = dirent->nxt;
+    }
+
+    return 0;
+}
+
+/**
+ * @brief      drop least recently used directories over the limit
+ *
+ * Only directories without loaded subdirectories and open entries are
+ * dropped, so descendants always go before their ancestors.
+ *
+ * @param      fs    filesystem
+ * @param      keep  directory to be kept (just loaded)
+ */
+static void vfs_dir_evict(fs_ifc *fs, file_desc *keep) {
+    while (loaded_dir->size(loaded_dir) > VFS_DIRS_LOADED_MAX) {
+        const list_node *victim = NULL;
+
+        const list_node *node = loaded_dir->get_front(loaded_dir);
+        while (node) {
+            vfs_dir *entry = node->ptr;
+            if (entry->dir != keep &&
+                (!victim || entry->stamp < ((vfs_dir *) victim->ptr)->stamp) &&
+                !dir_has_loaded(entry->dir) && !dir_is_open(entry->dir)) {
+                victim = node;
+            }
+
+            node = node->nxt;
+        }
+
+        if (!victim) {
+            return;
+        }
+
+        fs->unload(fs, ((vfs_dir *) victim->ptr)->dir);
+
+        loaded_dir->delete(loaded_dir, victim, free);
+    }
+}
+
+/**
+ * @brief      make sure directory entries are loaded
+ *
+ * @return     0 on success
+ */
+static int vfs_dir_load(fs_ifc *fs, file_desc *dir) {
+    if (!fs->load || !fs->unload) {
+        //! whole tree is loaded by mount
+        return dir->child ? 0 : -1;
+    }
+
+    const list_node *node = loaded_dir->get_front(loaded_dir);
+    while (node) {
+        vfs_dir *entry = node->ptr;
+        if (entry->dir == dir) {
+            entry->stamp = ++dir_clock;
+            return 0;
+        }
+
+        node = node->nxt;
+    }
+
+    if (dir->child) {
+        //! root, loaded once mounted and never dropped
+        return 0;
+    }
+
+    vfs_dir *entry = malloc(sizeof(vfs_dir));
+    if (!entry) {
+        return -2;
+    }
+
+    if (fs->load(fs, dir)) {
+        free(entry);
+        return -3;
+    }
+
+    entry->dir   = dir;
+    entry->stamp = ++dir_clock;
+
+    if (!loaded_dir->insert_after(loaded_dir, NULL, entry)) {
+        fs->unload(fs, dir);
+        free(entry);
+        return -4;
+    }
+
+    vfs_dir_evict(fs, dir);
+
+    return 0;
+}
+
+static file_desc *resolve_helper(list_ifc *entries, file_desc *root, fs_ifc *fs) {
     file_desc *to_find = NULL;
 
     if (!entries->size(entries)) {
@@ -144,6 +367,10 @@ static file_desc *resolve_helper(list_ifc *entries, file_desc *root) {
 
         to_find = NULL;
 
+        if (vfs_dir_load(fs, root)) {
+            return NULL;
+        }
+
         const list_node *dirent = root->child->get_front(root->child);
         while (dirent) {
             file_desc *desc = dirent->ptr;
@@ -195,7 +422,6 @@ static file_desc *resolve_helper(list_ifc *entries, file_desc *root) {
 }
 
 static int vfs_open(const void *conn, vfs_command *command, file_desc *root, fs_ifc *fs) {
-    (void) fs;
     file_desc *to_open = NULL;
     int ret = -1;
 
@@ -204,7 +430,11 @@ static int vfs_open(const void *conn, vfs_command *command, file_desc *root, fs_
         goto reply;
     }
 
-    to_open = resolve_helper(entries, root);
+    to_open = resolve_helper(entries, root, fs);
+    if (to_open && to_open->type == F_TYPE_DIR && vfs_dir_load(fs, to_open)) {
+        to_open = NULL;
+    }
+
     if (to_open) {
         if (!fd_get_by_desc(to_open)) {
             vfs_fd *fd = malloc(sizeof(vfs_fd));
@@ -212,6 +442,9 @@ static int vfs_open(const void *conn, vfs_command *command, file_desc *root, fs_
                 fd->fd = gen_fd();
                 fd->file = to_open;
                 fd->fpos = 0;
+                fd->seq_reads  = 0;
+                fd->ra_pending = 0;
+                fd->ra_end     = 0;
 
                 if (!open_fd->insert_after(open_fd, NULL, fd)) {
                     free(fd);
@@ -228,7 +461,7 @@ static int vfs_open(const void *conn, vfs_command *command, file_desc *root, fs_
         entries->destroy(entries, free);
     }
 
-    return vfs_send_reply(conn, ret, NULL, 0);
+    return vfs_send_reply(conn, command, ret, NULL, 0);
 }
 
 static int vfs_stat(const void *conn, vfs_command *command, file_desc *root, fs_ifc *fs) {
@@ -251,7 +484,88 @@ static int vfs_stat(const void *conn, vfs_command *command, file_desc *root, fs_
         ret = 0;
     }
 
-    return vfs_send_reply(conn, ret, (char *) stat, sizeof(file_stat));
+    return vfs_send_reply(conn, command, ret, (char *) stat, sizeof(file_stat));
+}
+
+static inline uint32_t vfs_readahead_window(void) {
+    return VFS_READAHEAD_BLOCKS * bcache_block_size(disk_cache);
+}
+
+/**
+ * @brief      detect sequential reader and schedule read-ahead
+ *
+ * Reads always continue at fpos, so descriptor read more than once is a
+ * sequential reader. Single read (e.g. of a header) doesn't pull the rest
+ * of the file.
+ *
+ * @param      fd    file descriptor
+ */
+static void vfs_readahead_check(vfs_fd *fd) {
+    if (fd->file->type != F_TYPE_REG) {
+        return;
+    }
+
+    if (fd->seq_reads < 2 && ++fd->seq_reads < 2) {
+        return;
+    }
+
+    //! refill once half of the window is consumed
+    if (fd->fpos < fd->file->size &&
+        fd->ra_end < fd->fpos + vfs_readahead_window() / 2) {
+        fd->ra_pending = 1;
+    }
+}
+
+/**
+ * @brief      issue one pending read-ahead
+ *
+ * @return     boolean value (read-ahead was issued)
+ */
+static int vfs_readahead(fs_ifc *fs) {
+    if (!fs->prefetch) {
+        return 0;
+    }
+
+    const list_node *node = open_fd->get_front(open_fd);
+    while (node) {
+        vfs_fd *fd = node->ptr;
+        if (fd->ra_pending) {
+            uint32_t start = fd->ra_end > fd->fpos ? fd->ra_end : fd->fpos;
+            uint32_t end   = fd->fpos + vfs_readahead_window();
+
+            fd->ra_pending = 0;
+            fd->ra_end     = end;
+
+            fs->prefetch(fs, fd->file, start, end - start);
+
+            return 1;
+        }
+
+        node = node->nxt;
+    }
+
+    return 0;
+}
+
+static int vfs_fd_read(const list_node *node, fs_ifc *fs, uint8_t *buf, uint32_t size) {
+    if (!node) {
+        return -1;
+    }
+
+    vfs_fd *fd = node->ptr;
+
+    if (fd->file->type == F_TYPE_DIR && vfs_dir_load(fs, fd->file)) {
+        return -1;
+    }
+
+    int read = fs->read(fs, fd->file, buf, size, fd->fpos);
+    if (read >= 0) {
+        fd->fpos += fd->file->type == F_TYPE_DIR ? 1 : read;
+
+        vfs_readahead_check(fd);
+    }
+
+    return read;
 }
 
 static int vfs_read(const void *conn, vfs_command *command, file_desc *root, fs_ifc *fs) {
@@ -261,49 +575,59 @@ static int vfs_read(const void *conn, vfs_command *command, file_desc *root, fs_
 
     vfs_rw_req *req = (void *) &command->buf;
 
-    uint8_t read_buf[VFS_BUF_MAX];
-
-    int read = 0;
-
     uint32_t read_sz = req->size;
+    if (read_sz > VFS_BUF_MAX) {
+        read_sz = VFS_BUF_MAX;
+    }
 
     const list_node *node = fd_get(req->fd);
-    if (node) {
-        vfs_fd *fd = node->ptr;
-        read = fs->read(fs, fd->file, read_buf, read_sz, fd->fpos);
-        if (read < 0) {
-            read = 0;
-        } else {
-            fd->fpos += fd->file->type == F_TYPE_DIR ? 1 : read;
 
-            ret = read;
-        }
+    //! read file data straight into the connection buffer if possible
+    vfs_reply *reply = NULL;
+    if (write_reserve(conn, sizeof(vfs_reply) + read_sz, (void **) &reply) > 0) {
+        ret = vfs_fd_read(node, fs, (uint8_t *) reply->buf, read_sz);
+
+        reply->ret = ret < 0 ? -1 : ret;
+        reply->id  = command->id;
+
+        return write_commit(conn, sizeof(vfs_reply) + (ret < 0 ? 0 : ret));
     }
 
-    return vfs_send_reply(conn, ret, (char *) read_buf, read);
+    uint8_t read_buf[VFS_BUF_MAX];
+
+    ret = vfs_fd_read(node, fs, read_buf, read_sz);
+    if (ret < 0) {
+        return vfs_send_reply(conn, command, -1, NULL, 0);
+    }
+
+    return vfs_send_reply(conn, command, ret, (char *) read_buf, ret);
 }
 
 static int vfs_write(const void *conn, vfs_command *command, file_desc *root, fs_ifc *fs) {
     (void) fs;
     (void) command;
     (void) root;
-    return vfs_send_reply(conn, -1, NULL, 0);
+    return vfs_send_reply(conn, command, -1, NULL, 0);
 }
 
 static int vfs_close(const void *conn, vfs_command *command, file_desc *root, fs_ifc *fs) {
     (void) root;
-    (void) fs;
     int ret = -1;
 
     vfs_fd_req *req = (void *) &command->buf;
 
     const list_node *node = fd_get(req->fd);
     if (node) {
+        vfs_fd *fd = node->ptr;
+        if (fs->release) {
+            fs->release(fs, fd->file);
+        }
+
         open_fd->delete(open_fd, node, free);
         ret = 0;
     }
 
-    return vfs_send_reply(conn, ret, NULL, 0);
+    return vfs_send_reply(conn, command, ret, NULL, 0);
 }
 
 static vfs_handler handlers[] = {
@@ -314,107 +638,278 @@ static vfs_handler handlers[] = {
     [VFS_CLOSE] = vfs_close,
 };
 
-int fstat(int fd, file_stat *stat) {
-    if (!stat) {
-        return -1;
+/**
+ * @brief      find thread's session
+ *
+ * NOTE: session_lock MUST be held
+ */
+static vfs_session *vfs_session_find(const void *thread) {
+    for (uint32_t i = 0; i < VFS_SESSIONS_MAX; i++) {
+        if (sessions[i].thread == thread) {
+            return &sessions[i];
+        }
     }
 
-    int ret = -1;
-
-    const void *conn = connect(VFS_PORT, sizeof(vfs_reply) + sizeof(file_stat));
-    if (conn) {
-        vfs_command cmd = {
-            .command = VFS_STAT,
-        };
-        vfs_fd_req req = {
-            .fd = fd,
-        };
+    return NULL;
+}
 
-        if (write(conn, &cmd, sizeof(vfs_command)) == sizeof(vfs_command) &&
-            write(conn, &req, sizeof(vfs_fd_req)) == sizeof(vfs_fd_req)) {
+/**
+ * @brief      get calling thread's session, (re)connect if needed
+ *
+ * NOTE: session_lock MUST be held
+ */
+static vfs_session *vfs_session_get(int reconnect) {
+    const void *thread = get_thread(NULL);
+
+    vfs_session *session = vfs_session_find(thread);
+    if (!session) {
+        session = vfs_session_find(NULL);
+    }
 
-            vfs_reply reply;
-            if (timed_read(conn, &reply, sizeof(vfs_reply), 100) == sizeof(vfs_reply) &&
-                timed_read(conn, stat, sizeof(file_stat), 100) == sizeof(file_stat)) {
-                ret = reply.ret;
-            }
+    if (!session) {
+        //! table is full: take the slot over. Kernel refuses to close
+        //! connection of a thread that is still alive, that one is closed
+        //! by the server when idle
+        session = &sessions[session_evict++ % VFS_SESSIONS_MAX];
+        if (session->conn) {
+            close(session->conn);
         }
 
-        close(conn);
+        session->conn = NULL;
     }
 
-    return ret;
+    if (session->thread != thread) {
+        session->thread  = thread;
+        session->conn    = NULL;
+        session->next_id = 0;
+    }
+
+    if (reconnect && session->conn) {
+        close(session->conn);
+        session->conn = NULL;
+    }
+
+    if (!session->conn) {
+        session->conn = connect(VFS_PORT, VFS_SOCK_BUFFER_SIZE);
+        if (!session->conn) {
+            session->thread = NULL;
+            return NULL;
+        }
+    }
+
+    return session;
 }
 
-int fopen(const char *path) {
-    if (!path || strsize(path) > VFS_BUF_MAX) {
+int vfs_submit(uint8_t command, const void *req, uint32_t req_size) {
+    if (req_size > VFS_BUF_MAX) {
         return -1;
     }
 
     int ret = -1;
 
-    const void *conn = connect(VFS_PORT, sizeof(vfs_command) + strsize(path));
-    if (conn) {
+    mutex_lock(&session_lock);
+
+    //! second attempt covers connection dropped by the server
+    for (int attempt = 0; attempt < 2 && ret < 0; attempt++) {
+        vfs_session *session = vfs_session_get(attempt);
+        if (!session) {
+            break;
+        }
+
         vfs_command cmd = {
-            .command = VFS_OPEN,
+            .command = command,
+            .id      = session->next_id,
         };
 
-        if (write(conn, &cmd, sizeof(vfs_command)) == sizeof(vfs_command) &&
-            write(conn, path, strsize(path)) == strsize(path)) {
+        //! header and arguments are published as one datagram
+        io_vec vec[] = {
+            {.data = &cmd,         .size = sizeof(vfs_command)},
+            {.data = (void *) req, .size = req_size},
+        };
 
-            vfs_reply reply;
-            if (timed_read(conn, &reply, sizeof(vfs_reply), 100) == sizeof(vfs_reply)) {
-                ret = reply.ret;
-            }
+        //! ring is full while earlier requests are in flight: wait
+        int written = 0;
+        uint32_t timeout = VFS_REPLY_TIMEOUT_MS;
+        while (!(written = writev(session->conn, vec, req_size ? 2 : 1)) && timeout--) {
+            sleep(1);
         }
 
-        close(conn);
+        if (written > 0) {
+            ret = session->next_id++;
+        } else if (!written) {
+            break;
+        }
     }
 
+    mutex_unlock(&session_lock);
+
     return ret;
 }
 
-int fread(int fd, char *buf, uint32_t buf_size) {
-    if (!buf || !buf_size) {
+int vfs_complete(int id, vfs_reply *reply, void *buf, uint32_t buf_size) {
+    if (id < 0 || !reply) {
         return -1;
     }
 
+    mutex_lock(&session_lock);
+    vfs_session *session = vfs_session_find(get_thread(NULL));
+    const void *conn = session ? session->conn : NULL;
+    mutex_unlock(&session_lock);
+
+    if (!conn) {
+        return -1;
+    }
+
+    //! fallback for a datagram the ring can't loan: scattered copy
+    io_vec vec[] = {
+        {.data = reply, .size = sizeof(vfs_reply)},
+        {.data = buf,   .size = buf_size},
+    };
+
     int ret = -1;
+    do {
+        const uint8_t *loan = NULL;
 
-    const void *conn = connect(VFS_PORT, sizeof(vfs_command) + buf_size);
-    if (conn) {
-        vfs_command cmd = {
-            .command = VFS_READ,
-        };
-        vfs_rw_req req = {
-            .fd = fd,
-            .size = buf_size,
-        };
-        if (write(conn, &cmd, sizeof(vfs_command)) == sizeof(vfs_command) &&
-            write(conn, &req, sizeof(vfs_rw_req)) == sizeof(vfs_rw_req)) {
-
-            vfs_reply reply;
-            if (timed_read(conn, &reply, sizeof(vfs_reply), 100) == sizeof(vfs_reply)) {
-                int offset = 0;
-                while (offset < reply.ret) {
-                    ret = timed_read(conn, buf + offset, buf_size - offset, 100);
-                    if (ret < 0) {
-                        break;
-                    }
+        uint32_t timeout = VFS_REPLY_TIMEOUT_MS;
+        while (!(ret = read_peek(conn, (const void **) &loan)) && timeout--) {
+            sleep(1);
+        }
 
-                    offset += ret;
+        if (ret >= (int) sizeof(vfs_reply)) {
+            uint32_t size = ret;
 
-                    ret = offset;
+            //! replies to abandoned requests are dropped without a copy
+            memcpy(reply, loan, sizeof(vfs_reply));
+            if (reply->id == id) {
+                uint32_t payload = size - sizeof(vfs_reply);
+                if (!buf || payload > buf_size) {
+                    payload = buf ? buf_size : 0;
                 }
+
+                if (payload) {
+                    memcpy(buf, loan + sizeof(vfs_reply), payload);
+                }
+
+                ret = sizeof(vfs_reply) + payload;
             }
+
+            if (read_release(conn, size) < 0) {
+                ret = -1;
+            }
+        } else if (ret > 0) {
+            //! too short for a reply
+            read_release(conn, ret);
+        } else if (ret < 0) {
+            //! datagram wraps around the ring end (or connection is gone)
+            ret = readv(conn, vec, buf && buf_size ? 2 : 1);
+        }
+
+        //! ring space was freed, server may be waiting for it
+        if (ret > 0) {
+            reply_events++;
+            if (reply_blocked) {
+                signal((const void *) &reply_events);
+            }
+        }
+    } while (ret >= (int) sizeof(vfs_reply) && reply->id != id);
+
+    return ret >= (int) sizeof(vfs_reply) ? ret - (int) sizeof(vfs_reply) : -1;
+}
+
+void vfs_session_close(void) {
+    mutex_lock(&session_lock);
+
+    vfs_session *session = vfs_session_find(get_thread(NULL));
+    if (session) {
+        if (session->conn) {
+            close(session->conn);
         }
 
-        close(conn);
+        session->thread = NULL;
+        session->conn   = NULL;
+    }
+
+    mutex_unlock(&session_lock);
+}
+
+bcache *vfs_bcache(void) {
+    return disk_cache;
+}
+
+/**
+ * @brief      send request to VFS and wait for the reply
+ *
+ * @return     reply payload size, otherwise negative
+ */
+static int vfs_call(uint8_t command, const void *req, uint32_t req_size,
+    vfs_reply *reply, void *buf, uint32_t buf_size) {
+    int id = vfs_submit(command, req, req_size);
+    if (id < 0) {
+        return id;
+    }
+
+    int ret = vfs_complete(id, reply, buf, buf_size);
+    if (ret < 0) {
+        //! late reply must not be left in a connection nobody reads
+        vfs_session_close();
     }
 
     return ret;
 }
 
+int fstat(int fd, file_stat *stat) {
+    if (!stat) {
+        return -1;
+    }
+
+    vfs_fd_req req = {
+        .fd = fd,
+    };
+
+    vfs_reply reply;
+
+    if (vfs_call(VFS_STAT, &req, sizeof(vfs_fd_req), &reply, stat, sizeof(file_stat)) != sizeof(file_stat)) {
+        return -1;
+    }
+
+    return reply.ret;
+}
+
+int fopen(const char *path) {
+    if (!path || strsize(path) > VFS_BUF_MAX) {
+        return -1;
+    }
+
+    vfs_reply reply;
+
+    if (vfs_call(VFS_OPEN, path, strsize(path), &reply, NULL, 0)) {
+        return -1;
+    }
+
+    return reply.ret;
+}
+
+int fread(int fd, char *buf, uint32_t buf_size) {
+    if (!buf || !buf_size) {
+        return -1;
+    }
+
+    vfs_rw_req req = {
+        .fd = fd,
+        .size = buf_size,
+    };
+
+    vfs_reply reply;
+
+    //! file data lands straight in the caller's buffer
+    int ret = vfs_call(VFS_READ, &req, sizeof(vfs_rw_req), &reply, buf, buf_size);
+    if (ret < 0 || reply.ret > ret) {
+        return -1;
+    }
+
+    return reply.ret;
+}
+
 int fwrite(int fd, const char *buf, uint32_t buf_size) {
     (void) fd;
     (void) buf;
@@ -423,30 +918,88 @@ int fwrite(int fd, const char *buf, uint32_t buf_size) {
 }
 
 int fclose(int fd) {
-    int ret = -1;
+    vfs_fd_req req = {
+        .fd = fd,
+    };
 
-    const void *conn = connect(VFS_PORT, sizeof(vfs_reply) + sizeof(vfs_fd_req));
-    if (conn) {
-        vfs_command cmd = {
-            .command = VFS_CLOSE,
-        };
-        vfs_fd_req req = {
-            .fd = fd,
-        };
+    vfs_reply reply;
 
-        if (write(conn, &cmd, sizeof(vfs_command)) == sizeof(vfs_command) &&
-            write(conn, &req, sizeof(vfs_fd_req)) == sizeof(vfs_fd_req)) {
+    if (vfs_call(VFS_CLOSE, &req, sizeof(vfs_fd_req), &reply, NULL, 0)) {
+        return -1;
+    }
 
-            vfs_reply reply;
-            if (timed_read(conn, &reply, sizeof(vfs_reply), 100) == sizeof(vfs_reply)) {
-                ret = reply.ret;
-            }
+    return reply.ret;
+}
+
+static const list_node *vfs_conn_get(const void *conn) {
+    const list_node *node = open_conn->get_front(open_conn);
+    while (node) {
+        vfs_conn *entry = node->ptr;
+        if (entry->conn == conn) {
+            return node;
         }
 
-        close(conn);
+        node = node->nxt;
     }
 
-    return ret;
+    return NULL;
+}
+
+static int vfs_conn_add(const void *conn) {
+    //! descriptor of connection closed by the client may be reused
+    const list_node *node = vfs_conn_get(conn);
+    if (node) {
+        open_conn->delete(open_conn, node, free);
+    }
+
+    vfs_conn *entry = malloc(sizeof(vfs_conn));
+    if (!entry) {
+        return -1;
+    }
+
+    entry->conn        = conn;
+    entry->last_active = clock_get();
+
+    if (!open_conn->insert_after(open_conn, NULL, entry)) {
+        free(entry);
+        return -1;
+    }
+
+    return 0;
+}
+
+static void vfs_conn_touch(const void *conn) {
+    const list_node *node = vfs_conn_get(conn);
+    if (node) {
+        vfs_conn *entry = node->ptr;
+        entry->last_active = clock_get();
+    }
+}
+
+static void vfs_conn_drop(const void *conn) {
+    const list_node *node = vfs_conn_get(conn);
+    if (node) {
+        open_conn->delete(open_conn, node, free);
+    }
+
+    close(conn);
+}
+
+static void vfs_conn_expire(void) {
+    int32_t now = clock_get();
+
+    const list_node *node = open_conn->get_front(open_conn);
+    while (node) {
+        const list_node *nxt = node->nxt;
+        vfs_conn *entry = node->ptr;
+
+        if (now - entry->last_active > VFS_SESSION_IDLE_MS) {
+            close(entry->conn);
+            open_conn->delete(open_conn, node, free);
+        }
+
+        node = nxt;
+    }
 }
 
 void vfs_loop(void) {
@@ -454,71 +1007,163 @@ void vfs_loop(void) {
     fs_ifc *fs = NULL;
     while (!root) {
         disk_ifc *disk = sd_spi_init(&cfg);
-        if (disk) {
-            disk_stat stat;
-            uint8_t buf[512];
-            if (!disk->read(disk, 0, buf)) {
-                disk->get_stat(disk, &stat);
+        bcache *cache = disk ?
+            bcache_create(disk, VFS_BCACHE_BLOCK_SIZE, VFS_BCACHE_SLOTS,
+                VFS_BCACHE_AHEAD_SLOTS) : NULL;
+        if (cache) {
+            const uint8_t *mbr = bcache_get(cache, 0);
+            if (mbr) {
+                part_info parts[MBR_PART_COUNT];
+                int       valid[MBR_PART_COUNT];
+
+                //! ext2_init resizes cache blocks, so don't keep MBR pinned
                 for (unsigned i = 0; i < MBR_PART_COUNT; ++i) {
-                    part_info info;
-                    if (mbr_get_part_info(buf, i, &info)) {
+                    valid[i] = !mbr_get_part_info((void *) mbr, i, &parts[i]);
+                }
+
+                bcache_put(cache, mbr);
+
+                for (unsigned i = 0; i < MBR_PART_COUNT; ++i) {
+                    if (!valid[i]) {
                         continue;
                     }
 
-                    fs = ext2_init(disk, info.start_sector);
+                    fs = ext2_init(cache, parts[i].start_sector);
                     if (fs) {
                         root = fs->mount(fs, "/");
                     }
 
+                    //! root entries stay loaded for the whole session
+                    if (root && fs->load && fs->load(fs, root)) {
+                        if (fs->unload) {
+                            fs->unload(fs, root);
+                        }
+
+                        free(root);
+                        root = NULL;
+                    }
+
                     if (root) {
-                        printf("\nrootfs mounted\nsize: %u MB\n", info.size_mb);
+                        printf("\nrootfs mounted\nsize: %u MB\n", parts[i].size_mb);
                         fs_current_path_set(root->name);
+                        disk_cache = cache;
                         break;
                     }
+
+                    //! context refers to the cache, which is destroyed below
+                    if (fs) {
+                        fs->destroy(fs);
+                        fs = NULL;
+                    }
                 }
             }
         }
 
+        if (!root) {
+            bcache_destroy(cache);
+            if (disk) {
+                disk->destroy(disk);
+            }
+        }
+
         sleep(1000);
     }
 
-    int ret = socket(VFS_PORT);
+    int ret = socket(VFS_PORT, SOCKET_DGRAM);
     ASSERT(!ret);
 
     open_fd = list_create();
     ASSERT(open_fd);
 
+    loaded_dir = list_create();
+    ASSERT(loaded_dir);
+
+    open_conn = list_create();
+    ASSERT(open_conn);
+
+    //! polling requests are batched: one supervisor call per step
+    sv_sqe   sq_entries[VFS_SQ_SIZE];
+    sv_queue sq;
+
+    ret = sq_init(&sq, sq_entries, VFS_SQ_SIZE);
+    ASSERT(!ret);
+
     while (1) {
-        sleep(1);
+        socket_port_request listen_req = {
+            .client    = NULL,
+            .port      = VFS_PORT,
+        };
+        socket_port_request select_req = {
+            .client    = NULL,
+            .port      = VFS_PORT,
+        };
+
+        sq_push(&sq, SVC_SOCK_LISTEN, &listen_req);
+        sq_push(&sq, SVC_SOCK_SELECT, &select_req);
+        submit(&sq);
 
-        const void *client = listen(VFS_PORT);
+        const void *client = listen_req.client;
         if (client) {
             const void * conn = accept(VFS_PORT, client, VFS_REPL_BUFFER_SIZE);
             if (!conn) {
                 LOG_DBG("Failed to accept sock connection");
+            } else if (vfs_conn_add(conn)) {
+                close(conn);
             }
         }
 
-        const void *connection = select(VFS_PORT);
-        if (connection) {
-            const void *connection_peer = peer(connection);
-            if (!connection_peer) {
-                LOG_ERR("sock peer not found");
+        const void *connection = select_req.client;
+        if (!connection) {
+            //! replies are out, load data sequential readers will ask next
+            if (vfs_readahead(fs)) {
                 continue;
             }
 
-            char io_buffer[VFS_SOCK_BUFFER_SIZE];
-            if (timed_read(connection, io_buffer, VFS_SOCK_BUFFER_SIZE, 100) >= (int) sizeof(vfs_command)) {
-                vfs_command *command = (void *) io_buffer;
-                if (command->command < sizeof(handlers)) {
-                    int ret = handlers[command->command](connection, command, root, fs);
-                    if (ret < 0) {
-                        LOG_ERR("Failed to respond control signal");
-                    }
+            vfs_conn_expire();
+
+            sleep(1);
+
+            continue;
+        }
+
+        //! selected connection has a complete datagram queued
+        char io_buffer[VFS_SOCK_BUFFER_SIZE];
+
+        socket_peer_request peer_req = {
+            .peer      = NULL,
+            .sock      = connection,
+        };
+        rw_request read_req = {
+            .result    = -21,
+            .dest      = connection,
+            .data      = io_buffer,
+            .data_size = VFS_SOCK_BUFFER_SIZE,
+        };
+
+        sq_push(&sq, SVC_PEER, &peer_req);
+        sq_push(&sq, SVC_READ, &read_req);
+        submit(&sq);
+
+        if (!peer_req.peer) {
+            LOG_ERR("sock peer not found");
+            continue;
+        }
+
+        vfs_conn_touch(connection);
+
+        //! pending requests are served back to back, no sleep in between
+        if (read_req.result >= (int) sizeof(vfs_command)) {
+            vfs_command *command = (void *) io_buffer;
+            if (command->command < countof(handlers)) {
+                int ret = handlers[command->command](connection, command, root, fs);
+                if (ret < 0) {
+                    //! reply is dropped, client gets a new session on retry
+                    LOG_ERR("Failed to respond control signal");
+                    vfs_conn_drop(connection);
                 }
-            } else {
-                LOG_ERR("Junk command");
             }
+        } else {
+            LOG_ERR("Junk command");
         }
     }
 }
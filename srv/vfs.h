@@ -5,6 +5,7 @@
 #include "kernel/syscall.h"
 #include "lib/string.h"
 #include "fs/fs.h"
+#include "driver/bcache.h"
 
 #define VFS_BUF_MAX 256
 
@@ -18,14 +19,29 @@ typedef enum vfs_control_t {
 
 typedef struct vfs_command_t {
     uint8_t           command;
+    /**
+     * request id, echoed back in the reply
+     */
+    uint16_t          id;
     char              buf[];
 } __attribute__((packed)) vfs_command;
 
 typedef struct vfs_reply_t {
     int32_t  ret;
+    uint16_t id;
     char     buf[];
 } __attribute__((packed)) vfs_reply;
 
+typedef struct vfs_rw_req_t {
+    int      fd;
+    uint32_t size;
+    char     buf[];
+} vfs_rw_req;
+
+typedef struct vfs_fd_req_t {
+    int fd;
+} vfs_fd_req;
+
 typedef struct file_stat_t {
     uint32_t  size;
     file_type type;
@@ -41,4 +57,45 @@ int fwrite(int fd, const char *buf, uint32_t buf_size);
 
 int fclose(int fd);
 
+/**
+ * @brief      queue request on calling thread's VFS session
+ *
+ * Session connection is opened on first use and kept, so several
+ * requests may be in flight on it.
+ *
+ * @param[in]  command   VFS command
+ * @param[in]  req       command arguments
+ * @param[in]  req_size  command arguments size
+ *
+ * @return     request id, otherwise negative
+ */
+int vfs_submit(uint8_t command, const void *req, uint32_t req_size);
+
+/**
+ * @brief      wait for reply to the request
+ *
+ * Replies come in submission order, replies to older (abandoned)
+ * requests are skipped.
+ *
+ * @param[in]  id        request id
+ * @param      reply     reply header
+ * @param      buf       reply payload buffer (may be NULL)
+ * @param[in]  buf_size  reply payload buffer size
+ *
+ * @return     reply payload size, otherwise negative
+ */
+int vfs_complete(int id, vfs_reply *reply, void *buf, uint32_t buf_size);
+
+/**
+ * @brief      close calling thread's VFS session
+ */
+void vfs_session_close(void);
+
+/**
+ * @brief      get block cache of the mounted disk
+ *
+ * @return     block cache, NULL until root filesystem is mounted
+ */
+bcache *vfs_bcache(void);
+
 #endif
@@ -0,0 +1,185 @@
+#include "common/def.h"
+#include "host/test.h"
+#include "host/file_disk.h"
+#include "driver/bcache.h"
+
+//! cache block of two disk blocks
+#define BLOCK      0x400
+#define STEP       (BLOCK / FILE_DISK_BLOCK_SIZE)
+
+static disk_ifc *disk;
+
+/**
+ * @brief      every disk block is filled with its number
+ */
+static void disk_fill(void) {
+    disk_stat stat;
+    disk->get_stat(disk, &stat);
+
+    uint8_t buf[FILE_DISK_BLOCK_SIZE];
+    for (uint32_t blk = 0; blk < stat.blocks; blk++) {
+        memset(buf, blk, sizeof(buf));
+        disk->write(disk, blk, buf);
+    }
+}
+
+//! data of cache block starting at `blk` is what disk_fill wrote
+static int block_ok(const uint8_t *data, uint32_t blk) {
+    for (uint32_t i = 0; i < BLOCK; i++) {
+        if (data[i] != (uint8_t) (blk + i / FILE_DISK_BLOCK_SIZE)) {
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+static uint32_t disk_requests(void) {
+    file_disk_stat stat;
+    file_disk_stat_get(disk, &stat);
+    file_disk_stat_reset(disk);
+
+    return stat.requests;
+}
+
+static void get_test(void) {
+    bcache *cache = bcache_create(disk, BLOCK, 2, 0);
+    CHECK(cache);
+
+    bcache_stat stat;
+
+    const uint8_t *a = bcache_get(cache, 0);
+    const uint8_t *b = bcache_get(cache, STEP);
+    CHECK(a && block_ok(a, 0));
+    CHECK(b && block_ok(b, STEP));
+
+    //! every slot is pinned
+    CHECK(!bcache_get(cache, 2 * STEP));
+
+    //! hit pins the slot once more
+    CHECK(bcache_get(cache, 0) == a);
+    bcache_put(cache, a);
+    bcache_put(cache, a);
+    bcache_put(cache, b);
+
+    const uint8_t *c = bcache_get(cache, 2 * STEP);
+    CHECK(c && block_ok(c, 2 * STEP));
+    bcache_put(cache, c + 10);
+
+    bcache_stat_get(cache, &stat);
+    CHECK(stat.hits == 1);
+    CHECK(stat.misses == 4);
+    CHECK(stat.evictions == 1);
+    CHECK(stat.disk_reads == 3 * STEP);
+
+    //! pinned slots keep the old block size
+    c = bcache_get(cache, 0);
+    CHECK(bcache_block_size_set(cache, 2 * BLOCK) == -2);
+    bcache_put(cache, c);
+    CHECK(!bcache_block_size_set(cache, 2 * BLOCK));
+    CHECK(bcache_block_size(cache) == 2 * BLOCK);
+
+    //! both slots have to fit one heap cell
+    CHECK(bcache_block_size_set(cache, 0x8000) == -3);
+    CHECK(bcache_block_size(cache) == 2 * BLOCK);
+
+    bcache_destroy(cache);
+
+    CHECK(!bcache_create(disk, 0x2000, 8, 0));
+    CHECK(!bcache_create(disk, 0x1000, 8, 8));
+}
+
+static void read_test(void) {
+    bcache *cache = bcache_create(disk, BLOCK, 4, 0);
+
+    static uint8_t buf[8 * BLOCK];
+
+    //! cache block 3 is cached, the rest is streamed in two runs
+    bcache_put(cache, bcache_get(cache, 3 * STEP));
+    disk_requests();
+
+    CHECK(!bcache_read(cache, 0, 8, buf));
+    CHECK(disk_requests() == 2);
+
+    for (uint32_t i = 0; i < 8; i++) {
+        CHECK(block_ok(buf + i * BLOCK, i * STEP));
+    }
+
+    //! streamed blocks aren't cached
+    bcache_stat stat;
+    bcache_stat_get(cache, &stat);
+    CHECK(stat.hits == 1);
+    CHECK(stat.misses == 8);
+
+    bcache_destroy(cache);
+}
+
+static void prefetch_test(void) {
+    bcache *cache = bcache_create(disk, BLOCK, 2, 4);
+    bcache_stat stat;
+
+    //! run goes into adjacent read-ahead slots with one transfer
+    disk_requests();
+    CHECK(bcache_prefetch(cache, 0, 3) == 3);
+    CHECK(disk_requests() == 1);
+
+    const uint8_t *data = bcache_get(cache, STEP);
+    CHECK(data && block_ok(data, STEP));
+    CHECK(!disk_requests());
+
+    //! block in use is kept, so only three blocks fit: the run is split
+    //! where read-ahead slots wrap around and at the pinned slot
+    CHECK(bcache_prefetch(cache, 3 * STEP, 4) == 3);
+    CHECK(disk_requests() == 3);
+
+    CHECK(bcache_get(cache, STEP) == data);
+    bcache_put(cache, data);
+    bcache_put(cache, data);
+
+    for (uint32_t i = 3; i < 6; i++) {
+        data = bcache_get(cache, i * STEP);
+        CHECK(data && block_ok(data, i * STEP));
+        bcache_put(cache, data);
+    }
+    CHECK(!disk_requests());
+
+    bcache_stat_get(cache, &stat);
+    CHECK(stat.prefetched == 6);
+    //! blocks 0 and 2 were replaced unused
+    CHECK(stat.prefetch_wasted == 2);
+    CHECK(stat.disk_reads == 6 * STEP);
+
+    //! no read-ahead slots: nothing is loaded
+    bcache_destroy(cache);
+    cache = bcache_create(disk, BLOCK, 2, 0);
+    CHECK(!bcache_prefetch(cache, 0, 4));
+    bcache_destroy(cache);
+}
+
+int main(int argc, char **argv) {
+    if (argc != 2) {
+        printf("usage: %s <image>\n", argv[0]);
+        return 2;
+    }
+
+    file_disk_config cfg = {
+        .path     = argv[1],
+        .writable = 1,
+    };
+
+    disk = file_disk_init(&cfg);
+    if (!disk) {
+        printf("failed to open %s\n", argv[1]);
+        return 1;
+    }
+
+    disk_fill();
+
+    get_test();
+    read_test();
+    prefetch_test();
+
+    disk->destroy(disk);
+
+    return TEST_RESULT("bcache_test");
+}
@@ -0,0 +1,31 @@
+#include "lib/crc.h"
+#include "lib/string.h"
+#include "platform/clock.h"
+
+#define CRC_BENCH_BLOCK      512
+#define CRC_BENCH_ITERATIONS 20000
+
+int main(void) {
+    static uint8_t buf[CRC_BENCH_BLOCK];
+
+    for (uint32_t i = 0; i < CRC_BENCH_BLOCK; i++) {
+        buf[i] = i * 7;
+    }
+
+    volatile uint16_t sink = 0;
+
+    uint32_t start = clock_get_us();
+    for (uint32_t i = 0; i < CRC_BENCH_ITERATIONS; i++) {
+        buf[0] = i;
+        sink ^= crc16(buf, CRC_BENCH_BLOCK);
+    }
+    uint32_t elapsed = clock_get_us() - start;
+
+    (void) sink;
+
+    printf("crc16 CRC_TABLES=%u: %u ns per %u B block\n", CRC_TABLES,
+        (uint32_t) ((uint64_t) elapsed * 1000 / CRC_BENCH_ITERATIONS),
+        CRC_BENCH_BLOCK);
+
+    return 0;
+}
@@ -0,0 +1,102 @@
+#include "host/test.h"
+#include "lib/crc.h"
+
+#define CRC_TEST_CASES 20000
+#define CRC_TEST_MAX   600
+
+typedef struct crc_vector_t {
+    const char *data;
+    uint32_t    len;
+    uint16_t    crc16;
+    uint8_t     crc7;
+} crc_vector;
+
+//! CRC-16/XMODEM and CRC-7/MMC check values, CMD0 and CMD8 frames
+static const crc_vector crc_vectors[] = {
+    { "",                         0, 0x0000, 0x00 },
+    { "123456789",                9, 0x31c3, 0x75 },
+    { "\x40\x00\x00\x00\x00",     5, 0x1168, 0x4a },
+    { "\x48\x00\x00\x01\xaa",     5, 0x34d4, 0x43 },
+};
+
+static uint32_t crc_seed = 1;
+
+static uint32_t crc_random(void) {
+    crc_seed = crc_seed * 1103515245 + 12345;
+    return crc_seed >> 8;
+}
+
+//! bitwise references, independent of the kernels under test
+static uint8_t crc7_ref(const uint8_t *buf, uint32_t len) {
+    uint8_t crc = 0;
+
+    while (len--) {
+        uint8_t byte = *buf++;
+        for (int i = 7; i >= 0; i--) {
+            uint8_t bit = ((crc >> 6) ^ (byte >> i)) & 1;
+            crc = ((crc << 1) & 0x7f) ^ (bit ? 0x09 : 0);
+        }
+    }
+
+    return crc << 1;
+}
+
+static uint16_t crc16_ref(const uint8_t *buf, uint32_t len) {
+    uint16_t crc = 0;
+
+    while (len--) {
+        uint8_t byte = *buf++;
+        for (int i = 7; i >= 0; i--) {
+            uint16_t bit = ((crc >> 15) ^ (byte >> i)) & 1;
+            crc = (crc << 1) ^ (bit ? 0x1021 : 0);
+        }
+    }
+
+    return crc;
+}
+
+static void vector_test(void) {
+    for (uint32_t i = 0; i < sizeof(crc_vectors) / sizeof(crc_vectors[0]); i++) {
+        const crc_vector *vec = &crc_vectors[i];
+        const uint8_t    *buf = (const uint8_t *) vec->data;
+
+        CHECK(crc16(buf, vec->len) == vec->crc16);
+        CHECK(crc7(buf, vec->len) >> 1 == vec->crc7);
+        CHECK(crc16_ref(buf, vec->len) == vec->crc16);
+        CHECK(crc7_ref(buf, vec->len) >> 1 == vec->crc7);
+    }
+}
+
+/**
+ * @brief      random buffers fed in two parts at random (unaligned) offsets
+ */
+static void random_test(void) {
+    static uint8_t data[CRC_TEST_MAX + 4];
+
+    for (uint32_t i = 0; i < CRC_TEST_CASES && !test_failures; i++) {
+        uint32_t len   = crc_random() % CRC_TEST_MAX;
+        uint32_t off   = crc_random() % 4;
+        uint32_t split = len ? crc_random() % len : 0;
+
+        uint8_t *buf = data + off;
+        for (uint32_t j = 0; j < len; j++) {
+            buf[j] = crc_random();
+        }
+
+        uint16_t ref16 = crc16_ref(buf, len);
+        CHECK(crc16(buf, len) == ref16);
+        CHECK(crc16_update(crc16(buf, split), buf + split, len - split) == ref16);
+
+        uint8_t ref7 = crc7_ref(buf, len);
+        CHECK(crc7(buf, len) == ref7);
+        CHECK(crc7_update(crc7(buf, split), buf + split, len - split) == ref7);
+    }
+}
+
+int main(void) {
+    vector_test();
+    random_test();
+
+    printf("CRC_TABLES=%u ", CRC_TABLES);
+    return TEST_RESULT("crc_test");
+}
@@ -0,0 +1,155 @@
+#include "common/def.h"
+#include "host/test.h"
+#include "host/file_disk.h"
+#include "driver/ram_disk.h"
+#include "platform/clock.h"
+
+#define DISK_TEST_BLOCKS 16
+
+static void fill(uint8_t *buf, uint32_t count, uint8_t seed) {
+    for (uint32_t i = 0; i < count * 512; i++) {
+        buf[i] = seed + i * 7;
+    }
+}
+
+/**
+ * @brief      checks shared by every disk_ifc implementation
+ */
+static void disk_check(disk_ifc *disk, uint32_t blocks) {
+    uint8_t out[4 * 512], in[4 * 512];
+
+    disk_stat stat;
+    CHECK(!disk->get_stat(disk, &stat));
+    CHECK(stat.block_size == 512);
+    CHECK(stat.blocks == blocks);
+
+    fill(out, 4, 1);
+    CHECK(!disk->write_blocks(disk, 2, 4, out));
+    CHECK(!disk->read_blocks(disk, 2, 4, in));
+    CHECK(!memcmp(out, in, sizeof(in)));
+
+    //! single block ops address the same blocks
+    CHECK(!disk->read(disk, 3, in));
+    CHECK(!memcmp(out + 512, in, 512));
+
+    fill(out, 1, 9);
+    CHECK(!disk->write(disk, blocks - 1, out));
+    CHECK(!disk->read_blocks(disk, blocks - 1, 1, in));
+    CHECK(!memcmp(out, in, 512));
+
+    CHECK(disk->read(disk, blocks, in) == -2);
+    CHECK(disk->read_blocks(disk, blocks - 1, 2, in) == -2);
+    CHECK(disk->write_blocks(disk, blocks - 3, 4, out) == -2);
+
+    CHECK(disk->read_blocks(disk, 0, 1, NULL) == -1);
+}
+
+/**
+ * @brief      per-block latency is charged for every block of a request
+ */
+static void disk_latency_check(disk_ifc *disk, uint8_t writable) {
+    uint8_t buf[4 * 512];
+
+    uint32_t start = clock_get_us();
+    CHECK(!disk->read_blocks(disk, 0, 4, buf));
+    CHECK(clock_get_us() - start >= 4 * 1000);
+
+    if (writable) {
+        start = clock_get_us();
+        CHECK(!disk->write(disk, 0, buf));
+        CHECK(clock_get_us() - start >= 2000);
+    }
+}
+
+static void ram_disk_test(void) {
+    ram_disk_config cfg = {
+        .blocks = DISK_TEST_BLOCKS,
+    };
+
+    disk_ifc *disk = ram_disk_init(&cfg);
+    CHECK(disk);
+    if (disk) {
+        disk_check(disk, DISK_TEST_BLOCKS);
+        disk->destroy(disk);
+    }
+
+    //! image allocated by the disk has to fit one heap cell
+    cfg.blocks = 0x10000 / RAM_DISK_BLOCK_SIZE;
+    CHECK(!ram_disk_init(&cfg));
+
+    static uint8_t image[DISK_TEST_BLOCKS * RAM_DISK_BLOCK_SIZE];
+    cfg.image            = image;
+    cfg.blocks           = DISK_TEST_BLOCKS;
+    cfg.read_latency_us  = 1000;
+    cfg.write_latency_us = 2000;
+
+    disk = ram_disk_init(&cfg);
+    CHECK(disk);
+    if (disk) {
+        disk_latency_check(disk, 1);
+        disk->destroy(disk);
+    }
+}
+
+static void file_disk_test(const char *path) {
+    file_disk_config cfg = {
+        .path     = path,
+        .writable = 1,
+    };
+
+    disk_ifc *disk = file_disk_init(&cfg);
+    CHECK(disk);
+    if (!disk) {
+        return;
+    }
+
+    disk_stat stat;
+    disk->get_stat(disk, &stat);
+
+    disk_check(disk, stat.blocks);
+
+    file_disk_stat fstat;
+    file_disk_stat_get(disk, &fstat);
+    CHECK(fstat.requests == 5);
+    CHECK(fstat.blocks_read == 6);
+    CHECK(fstat.blocks_written == 5);
+
+    disk->destroy(disk);
+
+    //! writes reach the image file
+    cfg.writable         = 0;
+    cfg.read_latency_us  = 1000;
+    cfg.write_latency_us = 2000;
+
+    disk = file_disk_init(&cfg);
+    CHECK(disk);
+    if (!disk) {
+        return;
+    }
+
+    uint8_t out[512], in[512];
+    fill(out, 1, 9);
+    CHECK(!disk->read(disk, stat.blocks - 1, in));
+    CHECK(!memcmp(out, in, 512));
+
+    CHECK(disk->write(disk, 0, out) == -3);
+
+    disk_latency_check(disk, 0);
+
+    disk->destroy(disk);
+
+    cfg.path = "/nonexistent";
+    CHECK(!file_disk_init(&cfg));
+}
+
+int main(int argc, char **argv) {
+    if (argc != 2) {
+        printf("usage: %s <image>\n", argv[0]);
+        return 2;
+    }
+
+    ram_disk_test();
+    file_disk_test(argv[1]);
+
+    return TEST_RESULT("disk_test");
+}
@@ -0,0 +1,107 @@
+#include "common/def.h"
+#include "host/host.h"
+#include "host/ext2_image.h"
+#include "host/file_disk.h"
+#include "kernel/syscall.h"
+#include "lib/string.h"
+
+//! read-ahead slots of VFS cache
+#define EXT2_BENCH_AHEAD 5
+
+static void stat_reset(ext2_image *image) {
+    file_disk_stat_reset(image->disk);
+    bcache_stat_reset(image->cache);
+}
+
+static void stat_print(ext2_image *image) {
+    file_disk_stat disk;
+    bcache_stat    cache;
+
+    file_disk_stat_get(image->disk, &disk);
+    bcache_stat_get(image->cache, &cache);
+
+    printf("%u sectors / %u requests, %u cache lookups (%u misses)\n",
+        disk.blocks_read, disk.requests, cache.hits + cache.misses, cache.misses);
+}
+
+/**
+ * @brief      read one file through fresh mount
+ */
+static void read_bench(const char *path, const char *file_path, uint32_t chunk,
+    uint8_t readahead) {
+    ext2_image image;
+    if (ext2_image_mount(&image, path, readahead ? EXT2_BENCH_AHEAD : 0)) {
+        printf("%s: mount failed\n", path);
+        return;
+    }
+
+    file_desc *file = ext2_image_lookup(&image, file_path);
+    if (!file) {
+        printf("%s: not found\n", file_path);
+        ext2_image_unmount(&image);
+        return;
+    }
+
+    uint8_t *data = malloc(file->size + chunk);
+
+    stat_reset(&image);
+    ext2_image_read(&image, file, data, chunk, readahead);
+
+    printf("%-15s %5u B reads, read-ahead %s: ", file_path, chunk,
+        readahead ? "on " : "off");
+    stat_print(&image);
+
+    free(data);
+    ext2_image_unmount(&image);
+}
+
+/**
+ * @brief      mount cost and heap held by loaded directories
+ */
+static void tree_bench(const char *path) {
+    uint32_t heap = host_heap_used();
+
+    ext2_image image;
+    if (ext2_image_mount(&image, path, 0)) {
+        printf("%s: mount failed\n", path);
+        return;
+    }
+
+    printf("mount: ");
+    stat_print(&image);
+    printf("heap after mount (block cache included): %u B\n", host_heap_used() - heap);
+
+    stat_reset(&image);
+    file_desc *file = ext2_image_lookup(&image, "/t3/d5/s/g4");
+
+    printf("open /t3/d5/s/g4: ");
+    stat_print(&image);
+    printf("heap after open: %u B\n", host_heap_used() - heap);
+
+    if (file) {
+        uint8_t data[16];
+        ext2_image_read(&image, file, data, sizeof(data), 0);
+    }
+
+    ext2_image_unmount(&image);
+}
+
+int main(int argc, char **argv) {
+    if (argc != 3) {
+        printf("usage: %s <files image> <tree image>\n", argv[0]);
+        return 2;
+    }
+
+    for (uint32_t readahead = 0; readahead < 2; readahead++) {
+        read_bench(argv[1], "/big.bin", 256, readahead);
+        read_bench(argv[1], "/big.bin", 4096, readahead);
+        read_bench(argv[1], "/d1/d2/mid.bin", 256, readahead);
+    }
+
+    //! whole-block runs bypass cache slots
+    read_bench(argv[1], "/big.bin", 65536, 0);
+
+    tree_bench(argv[2]);
+
+    return 0;
+}
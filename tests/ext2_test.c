@@ -0,0 +1,165 @@
+#include "common/def.h"
+#include "host/test.h"
+#include "host/host.h"
+#include "host/ext2_image.h"
+#include "kernel/syscall.h"
+
+//! read-ahead slots of VFS cache
+#define EXT2_TEST_AHEAD 5
+
+/**
+ * @brief      compare file with its copy in image source tree
+ */
+static void file_check(ext2_image *image, const char *root, const char *path,
+    uint32_t chunk, uint8_t readahead) {
+    char host_path[256];
+    snprintf(host_path, sizeof(host_path), "%s%s", root, path);
+
+    uint32_t size;
+    uint8_t *ref = host_file_load(host_path, &size);
+    CHECK(ref);
+
+    file_desc *file = ext2_image_lookup(image, path);
+    CHECK(file && file->type == F_TYPE_REG);
+
+    if (!ref || !file) {
+        printf("  %s\n", path);
+        free(ref);
+        return;
+    }
+
+    CHECK(file->size == size);
+
+    uint8_t *data = malloc(size + chunk);
+    CHECK(ext2_image_read(image, file, data, chunk, readahead) == (int) size);
+
+    if (memcmp(data, ref, size)) {
+        printf("%s: data mismatch, chunk %u, read-ahead %u\n", path, chunk,
+            readahead);
+        test_failures++;
+    }
+
+    free(data);
+    free(ref);
+}
+
+static void files_test(const char *path) {
+    static const char *files[] = {
+        "/big.bin", "/d1/small.txt", "/d1/f7", "/d1/d2/mid.bin",
+    };
+
+    char root[256];
+    snprintf(root, sizeof(root), "%s.root", path);
+
+    ext2_image image;
+    CHECK(!ext2_image_mount(&image, path, EXT2_TEST_AHEAD));
+    if (!image.fs) {
+        return;
+    }
+
+    for (uint32_t i = 0; i < sizeof(files) / sizeof(files[0]); i++) {
+        file_check(&image, root, files[i], 256, 0);
+        file_check(&image, root, files[i], 256, 1);
+        file_check(&image, root, files[i], 4096, 0);
+        file_check(&image, root, files[i], 4096, 1);
+        file_check(&image, root, files[i], 1000, 1);
+    }
+
+    CHECK(!ext2_image_lookup(&image, "/d1/none"));
+    CHECK(!ext2_image_lookup(&image, "/big.bin/x"));
+
+    file_desc *dir = ext2_image_lookup(&image, "/d1");
+    CHECK(dir && dir->type == F_TYPE_DIR && dir->child);
+
+    //! unloaded directory is loaded again on lookup
+    image.fs->unload(image.fs, dir);
+    CHECK(!dir->child);
+    file_check(&image, root, "/d1/d2/mid.bin", 256, 1);
+
+    ext2_image_unmount(&image);
+}
+
+/**
+ * @brief      group descriptor table too large for one heap cell, inodes
+ *             are spread over many groups
+ */
+static void groups_test(const char *path) {
+    char root[256];
+    snprintf(root, sizeof(root), "%s.root", path);
+
+    ext2_image image;
+    CHECK(!ext2_image_mount(&image, path, 0));
+    if (!image.fs) {
+        return;
+    }
+
+    for (uint32_t d = 1; d <= 30; d++) {
+        for (uint32_t f = 1; f <= 10; f++) {
+            char file[32];
+            snprintf(file, sizeof(file), "/d%02u/f%02u", d, f);
+            file_check(&image, root, file, 1000, 0);
+        }
+    }
+
+    ext2_image_unmount(&image);
+}
+
+/**
+ * @brief      many directories, each loaded on demand and dropped after use
+ */
+static void tree_test(const char *path) {
+    ext2_image image;
+    CHECK(!ext2_image_mount(&image, path, 0));
+    if (!image.fs) {
+        return;
+    }
+
+    //! mount loads root only
+    file_desc *dir = ext2_image_lookup(&image, "/t3");
+    CHECK(dir && !dir->child);
+
+    char root[256];
+    snprintf(root, sizeof(root), "%s.root", path);
+    file_check(&image, root, "/t3/d5/s/g4", 256, 0);
+
+    for (uint32_t t = 1; t <= 8; t++) {
+        for (uint32_t d = 1; d <= 16; d++) {
+            for (uint32_t f = 1; f <= 20; f++) {
+                char name[32], expected[32], data[32];
+                snprintf(name, sizeof(name), "/t%u/d%u/f%02u", t, d, f);
+                snprintf(expected, sizeof(expected), "%u/%u/%02u\n", t, d, f);
+                uint32_t length = strlen(expected);
+
+                file_desc *file = ext2_image_lookup(&image, name);
+                CHECK(file && file->size == length);
+                if (!file) {
+                    continue;
+                }
+
+                CHECK(ext2_image_read(&image, file, (uint8_t *) data, 32, 0) ==
+                    (int) length);
+                CHECK(!memcmp(data, expected, length));
+            }
+
+            snprintf(root, sizeof(root), "/t%u/d%u", t, d);
+            dir = ext2_image_lookup(&image, root);
+            image.fs->unload(image.fs, dir);
+            CHECK(dir && !dir->child);
+        }
+    }
+
+    ext2_image_unmount(&image);
+}
+
+int main(int argc, char **argv) {
+    if (argc != 4) {
+        printf("usage: %s <files image> <groups image> <tree image>\n", argv[0]);
+        return 2;
+    }
+
+    files_test(argv[1]);
+    groups_test(argv[2]);
+    tree_test(argv[3]);
+
+    return TEST_RESULT("ext2_test");
+}
@@ -0,0 +1,46 @@
+#include "lib/string.h"
+#include "lib/format.h"
+#include "platform/clock.h"
+
+#define FORMAT_BENCH_LINES 200000
+
+/**
+ * @brief      time formatting of one line into a buffer sink
+ */
+static void format_bench(const char *name, int kind) {
+    char buffer[128];
+    fmt_buffer_sink sink;
+
+    uint32_t start = clock_get_us();
+
+    for (int i = 0; i < FORMAT_BENCH_LINES; i++) {
+        fmt_buffer_sink_init(&sink, buffer, sizeof(buffer));
+
+        switch (kind) {
+            case 0:
+                format(&sink.sink, "[ERROR] %s::%s():%d Error reply received: %d",
+                    "utils/src/led.c", "led_cmd_handler", 49, -i);
+                break;
+            case 1:
+                format(&sink.sink, "r%d = 0x%08x psr = 0x%08x", i & 15,
+                    i * 2654435761u, i);
+                break;
+            default:
+                format(&sink.sink, "%s/%s", "/mnt/sd/some/dir", "file.txt");
+                break;
+        }
+    }
+
+    uint32_t elapsed = clock_get_us() - start;
+
+    printf("%s: %u ns/line\n", name,
+        (uint32_t) ((uint64_t) elapsed * 1000 / FORMAT_BENCH_LINES));
+}
+
+int main(void) {
+    format_bench("log line ", 0);
+    format_bench("hex dump ", 1);
+    format_bench("path join", 2);
+
+    return 0;
+}
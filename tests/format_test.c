@@ -0,0 +1,117 @@
+#include "common/def.h"
+#include "host/test.h"
+#include "lib/format.h"
+
+/**
+ * @brief      format into buffer sink and compare with expected output
+ */
+static void format_check(const char *expected, uint32_t size, const char *fmt, ...) {
+    char buffer[64];
+
+    fmt_buffer_sink sink;
+    fmt_buffer_sink_init(&sink, buffer, size);
+
+    va_list va;
+    va_start(va, fmt);
+    int ret = vformat(&sink.sink, fmt, va);
+    va_end(va);
+
+    CHECK(!strcmp(buffer, expected));
+    if (strcmp(buffer, expected)) {
+        printf("  \"%s\": got \"%s\"\n", fmt, buffer);
+    }
+
+    //! return value doesn't depend on truncation
+    char full[256];
+    fmt_buffer_sink_init(&sink, full, sizeof(full));
+    va_start(va, fmt);
+    vformat(&sink.sink, fmt, va);
+    va_end(va);
+
+    CHECK(ret == strlen(full));
+}
+
+/**
+ * sink recording chunk boundaries
+ */
+typedef struct chunk_sink_t {
+    fmt_sink               sink;
+    char                   out[128];
+    uint32_t               len;
+    uint32_t               chunks;
+} chunk_sink;
+
+static void chunk_write(fmt_sink *sink, const char *data, uint32_t len) {
+    chunk_sink *chunk = (chunk_sink*) sink;
+
+    memcpy(chunk->out + chunk->len, data, len);
+    chunk->len += len;
+    chunk->out[chunk->len++] = '|';
+    chunk->chunks++;
+}
+
+static void conversion_test(void) {
+    format_check("-0042|  -42|-2147483648|4294967295|ff|FF|0000beef|z|str|%| ab",
+        64, "%05d|%5d|%d|%u|%x|%X|%08x|%c|%s|%%|%3s", -42, -42,
+        -2147483647 - 1, 4294967295u, 255, 255, 0xbeef, 'z', "str", "ab");
+
+    format_check("05:07", 64, "%02d:%02d", 5, 7);
+    format_check("0", 64, "%d", 0);
+    format_check("(null)", 64, "%s", NULL);
+
+    //! multi-digit widths, fill longer than one fill chunk
+    format_check("                  x", 64, "%19s", "x");
+    format_check("000000000000000000042", 64, "%021u", 42);
+
+    //! unknown conversion is put as is, trailing '%' is dropped
+    format_check("-y-", 64, "-%y-");
+    format_check("ab", 64, "ab%");
+}
+
+static void truncation_test(void) {
+    format_check("hell", 5, "hello world");
+    format_check("", 1, "x");
+    format_check("12", 3, "%d", 12345);
+    format_check("ab  ", 5, "ab%5d", 1);
+
+    //! zero sized buffer stays untouched
+    char buffer[4] = "abc";
+
+    fmt_buffer_sink sink;
+    fmt_buffer_sink_init(&sink, buffer, 0);
+    CHECK(format(&sink.sink, "%s", "xyz") == 3);
+    CHECK(!strcmp(buffer, "abc"));
+}
+
+static void sink_test(void) {
+    //! literal spans and fields are passed as single chunks
+    chunk_sink chunk = {
+        .sink.write = chunk_write,
+    };
+
+    CHECK(format(&chunk.sink, "r%d = 0x%04x%s", 15, 0xbeef, "!") == 13);
+    chunk.out[chunk.len] = 0;
+    CHECK(!strcmp(chunk.out, "r|15| = 0x|beef|!|"));
+    CHECK(chunk.chunks == 5);
+
+    //! ring sink drops what doesn't fit
+    uint8_t storage[8];
+    ring_buffer ring;
+    ring_init(&ring, storage, sizeof(storage));
+
+    fmt_ring_sink rsink;
+    fmt_ring_sink_init(&rsink, &ring);
+    format(&rsink.sink, "%s%d", "abc", 42);
+
+    char out[8] = { 0 };
+    CHECK(ring_read(&ring, out, sizeof(out)) == 5);
+    CHECK(!strcmp(out, "abc42"));
+}
+
+int main(void) {
+    conversion_test();
+    truncation_test();
+    sink_test();
+
+    return TEST_RESULT("format_test");
+}
@@ -0,0 +1,147 @@
+#include "host/ext2_image.h"
+#include "host/file_disk.h"
+#include "kernel/syscall.h"
+#include "lib/string.h"
+
+//! VFS cache geometry (srv/src/vfs.c)
+#define EXT2_IMAGE_CACHE_BLOCK 0x400
+#define EXT2_IMAGE_CACHE_SLOTS 0x08
+#define EXT2_IMAGE_READAHEAD   0x04
+
+int ext2_image_mount(ext2_image *image, const char *path, uint32_t ahead_count) {
+    memset(image, 0, sizeof(ext2_image));
+
+    file_disk_config cfg = {
+        .path = path,
+    };
+
+    image->disk = file_disk_init(&cfg);
+    if (!image->disk) {
+        return -1;
+    }
+
+    image->cache = bcache_create(image->disk, EXT2_IMAGE_CACHE_BLOCK,
+        EXT2_IMAGE_CACHE_SLOTS, ahead_count);
+    if (!image->cache) {
+        ext2_image_unmount(image);
+        return -2;
+    }
+
+    image->fs = ext2_init(image->cache, 0);
+    if (!image->fs) {
+        ext2_image_unmount(image);
+        return -3;
+    }
+
+    image->root = image->fs->mount(image->fs, "/");
+    if (!image->root) {
+        ext2_image_unmount(image);
+        return -4;
+    }
+
+    return 0;
+}
+
+void ext2_image_unmount(ext2_image *image) {
+    if (image->root) {
+        image->fs->unload(image->fs, image->root);
+        free(image->root);
+    }
+
+    if (image->fs) {
+        image->fs->destroy(image->fs);
+    }
+
+    if (image->cache) {
+        bcache_destroy(image->cache);
+    }
+
+    if (image->disk) {
+        image->disk->destroy(image->disk);
+    }
+
+    memset(image, 0, sizeof(ext2_image));
+}
+
+/**
+ * @brief      find directory entry by name (length given)
+ */
+static file_desc *dir_find(ext2_image *image, file_desc *dir, const char *name,
+    uint32_t len) {
+    if (dir->type != F_TYPE_DIR) {
+        return NULL;
+    }
+
+    if (!dir->child && image->fs->load(image->fs, dir)) {
+        return NULL;
+    }
+
+    const list_node *node = dir->child->get_front(dir->child);
+    while (node) {
+        file_desc *entry = node->ptr;
+
+        if (strlen(entry->name) == (int) len && !strncmp(entry->name, name, len)) {
+            return entry;
+        }
+
+        node = node->nxt;
+    }
+
+    return NULL;
+}
+
+file_desc *ext2_image_lookup(ext2_image *image, const char *path) {
+    file_desc *file = image->root;
+
+    while (file && *path) {
+        while (*path == '/') {
+            path++;
+        }
+
+        const char *end = path;
+        while (*end && *end != '/') {
+            end++;
+        }
+
+        if (end != path) {
+            file = dir_find(image, file, path, end - path);
+        }
+
+        path = end;
+    }
+
+    return file;
+}
+
+int ext2_image_read(ext2_image *image, file_desc *file, uint8_t *buf,
+    uint32_t chunk, uint8_t readahead) {
+    fs_ifc  *fs     = image->fs;
+    uint32_t window = EXT2_IMAGE_READAHEAD * bcache_block_size(image->cache);
+    uint32_t fpos   = 0;
+    uint32_t ra_end = 0;
+    uint32_t reads  = 0;
+
+    while (fpos < file->size) {
+        int read = fs->read(fs, file, buf + fpos, chunk, fpos);
+        if (read <= 0) {
+            fs->release(fs, file);
+            return -1;
+        }
+
+        fpos += read;
+
+        //! second read marks sequential reader, then refill at half window
+        if (readahead && fs->prefetch && ++reads >= 2 &&
+            fpos < file->size && ra_end < fpos + window / 2) {
+            uint32_t start = ra_end > fpos ? ra_end : fpos;
+
+            ra_end = fpos + window;
+
+            fs->prefetch(fs, file, start, ra_end - start);
+        }
+    }
+
+    fs->release(fs, file);
+
+    return fpos;
+}
@@ -0,0 +1,61 @@
+#ifndef TESTS_HOST_EXT2_IMAGE_H
+#define TESTS_HOST_EXT2_IMAGE_H
+
+#include "common/common.h"
+#include "driver/bcache.h"
+#include "fs/ext2.h"
+
+/**
+ * ext2 image mounted the way VFS mounts a partition: file disk, block
+ * cache of VFS geometry, ext2 on top
+ */
+typedef struct ext2_image_t {
+    disk_ifc          *disk;
+    bcache            *cache;
+    fs_ifc            *fs;
+    file_desc         *root;
+} ext2_image;
+
+/**
+ * @brief      mount image
+ *
+ * @param      image        mounted image (output)
+ * @param[in]  path         image file
+ * @param[in]  ahead_count  read-ahead slots of the cache
+ *
+ * @return     0 on success
+ */
+int ext2_image_mount(ext2_image *image, const char *path, uint32_t ahead_count);
+
+/**
+ * @brief      unmount image, every resource is released
+ */
+void ext2_image_unmount(ext2_image *image);
+
+/**
+ * @brief      find file, directories on the way are loaded
+ *
+ * @param[in]  path  absolute path
+ *
+ * @return     file, NULL if not found
+ */
+file_desc *ext2_image_lookup(ext2_image *image, const char *path);
+
+/**
+ * @brief      read whole file in chunks as VFS serves its reads
+ *
+ * With `readahead` set, read-ahead follows VFS: from the second read on,
+ * VFS_READAHEAD_BLOCKS cache blocks are kept loaded ahead of the reader
+ * and refilled once half of them are consumed.
+ *
+ * @param      file       regular file
+ * @param      buf        destination (file size bytes)
+ * @param[in]  chunk      read size
+ * @param[in]  readahead  boolean value (emulate VFS read-ahead)
+ *
+ * @return     bytes read, negative on failure
+ */
+int ext2_image_read(ext2_image *image, file_desc *file, uint8_t *buf,
+    uint32_t chunk, uint8_t readahead);
+
+#endif
@@ -0,0 +1,157 @@
+#include "host/file_disk.h"
+
+#include <fcntl.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+typedef struct file_disk_ctx_t {
+    disk_ifc          ifc;
+    file_disk_config  cfg;
+    file_disk_stat    stat;
+    int               fd;
+    uint8_t          *image;
+    uint32_t          blocks;
+} file_disk_ctx;
+
+/**
+ * @brief      sleep for injected access latency
+ */
+static void file_disk_delay(uint32_t latency_us) {
+    if (latency_us) {
+        usleep(latency_us);
+    }
+}
+
+static int file_disk_read_blocks(disk_ifc *ifc, uint32_t blk, uint32_t count, uint8_t *buf) {
+    file_disk_ctx *ctx = (file_disk_ctx *) ifc;
+    if (!ctx || !buf) {
+        return -1;
+    }
+
+    if (blk >= ctx->blocks || count > ctx->blocks - blk) {
+        return -2;
+    }
+
+    file_disk_delay(ctx->cfg.read_latency_us * count);
+
+    memcpy(buf, ctx->image + (size_t) blk * FILE_DISK_BLOCK_SIZE,
+        count * FILE_DISK_BLOCK_SIZE);
+
+    ctx->stat.requests++;
+    ctx->stat.blocks_read += count;
+
+    return 0;
+}
+
+static int file_disk_write_blocks(disk_ifc *ifc, uint32_t blk, uint32_t count, const uint8_t *buf) {
+    file_disk_ctx *ctx = (file_disk_ctx *) ifc;
+    if (!ctx || !buf) {
+        return -1;
+    }
+
+    if (blk >= ctx->blocks || count > ctx->blocks - blk) {
+        return -2;
+    }
+
+    if (!ctx->cfg.writable) {
+        return -3;
+    }
+
+    file_disk_delay(ctx->cfg.write_latency_us * count);
+
+    memcpy(ctx->image + (size_t) blk * FILE_DISK_BLOCK_SIZE, buf,
+        count * FILE_DISK_BLOCK_SIZE);
+
+    ctx->stat.requests++;
+    ctx->stat.blocks_written += count;
+
+    return 0;
+}
+
+static int file_disk_read(disk_ifc *ifc, uint32_t blk, uint8_t *buf) {
+    return file_disk_read_blocks(ifc, blk, 1, buf);
+}
+
+static int file_disk_write(disk_ifc *ifc, uint32_t blk, const uint8_t *buf) {
+    return file_disk_write_blocks(ifc, blk, 1, buf);
+}
+
+static int file_disk_get_stat(disk_ifc *ifc, disk_stat *stat) {
+    file_disk_ctx *ctx = (file_disk_ctx *) ifc;
+    if (!ctx || !stat) {
+        return -1;
+    }
+
+    stat->size_mb    = ctx->blocks / (0x100000 / FILE_DISK_BLOCK_SIZE);
+    stat->block_size = FILE_DISK_BLOCK_SIZE;
+    stat->blocks     = ctx->blocks;
+
+    return 0;
+}
+
+static void file_disk_destroy(disk_ifc *ifc) {
+    file_disk_ctx *ctx = (file_disk_ctx *) ifc;
+    if (!ctx) {
+        return;
+    }
+
+    munmap(ctx->image, (size_t) ctx->blocks * FILE_DISK_BLOCK_SIZE);
+    close(ctx->fd);
+    free(ctx);
+}
+
+void file_disk_stat_get(disk_ifc *ifc, file_disk_stat *stat) {
+    memcpy(stat, &((file_disk_ctx *) ifc)->stat, sizeof(file_disk_stat));
+}
+
+void file_disk_stat_reset(disk_ifc *ifc) {
+    memset(&((file_disk_ctx *) ifc)->stat, 0, sizeof(file_disk_stat));
+}
+
+disk_ifc *file_disk_init(const file_disk_config *cfg) {
+    if (!cfg || !cfg->path) {
+        return NULL;
+    }
+
+    file_disk_ctx *ctx = calloc(1, sizeof(file_disk_ctx));
+    if (!ctx) {
+        return NULL;
+    }
+
+    memcpy(&ctx->cfg, cfg, sizeof(file_disk_config));
+
+    ctx->fd = open(cfg->path, cfg->writable ? O_RDWR : O_RDONLY);
+    if (ctx->fd < 0) {
+        free(ctx);
+        return NULL;
+    }
+
+    struct stat st;
+    if (fstat(ctx->fd, &st) || st.st_size / FILE_DISK_BLOCK_SIZE == 0 ||
+        st.st_size / FILE_DISK_BLOCK_SIZE > UINT32_MAX) {
+        close(ctx->fd);
+        free(ctx);
+        return NULL;
+    }
+
+    ctx->blocks = st.st_size / FILE_DISK_BLOCK_SIZE;
+
+    ctx->image = mmap(NULL, (size_t) ctx->blocks * FILE_DISK_BLOCK_SIZE,
+        PROT_READ | (cfg->writable ? PROT_WRITE : 0), MAP_SHARED, ctx->fd, 0);
+    if (ctx->image == MAP_FAILED) {
+        close(ctx->fd);
+        free(ctx);
+        return NULL;
+    }
+
+    ctx->ifc.read         = file_disk_read;
+    ctx->ifc.write        = file_disk_write;
+    ctx->ifc.read_blocks  = file_disk_read_blocks;
+    ctx->ifc.write_blocks = file_disk_write_blocks;
+    ctx->ifc.get_stat     = file_disk_get_stat;
+    ctx->ifc.destroy      = file_disk_destroy;
+
+    return &ctx->ifc;
+}
@@ -0,0 +1,53 @@
+#ifndef TESTS_HOST_FILE_DISK_H
+#define TESTS_HOST_FILE_DISK_H
+
+#include "common/common.h"
+#include "driver/disk.h"
+
+#define FILE_DISK_BLOCK_SIZE 512
+
+/**
+ * host disk backed by an image file mapped into memory, writes go
+ * straight to the image
+ */
+typedef struct file_disk_config_t {
+    /**
+     * image file, trailing partial block is ignored
+     */
+    const char       *path;
+    //! open image for writing, read only disk otherwise
+    uint8_t           writable;
+    /**
+     * injected per-block access latency in microseconds (0 - none)
+     */
+    uint32_t          read_latency_us;
+    uint32_t          write_latency_us;
+} file_disk_config;
+
+typedef struct file_disk_stat_t {
+    //! read_blocks/write_blocks calls, single block ops included
+    uint32_t requests;
+    uint32_t blocks_read;
+    uint32_t blocks_written;
+} file_disk_stat;
+
+/**
+ * @brief      map disk image
+ *
+ * @param[in]  cfg   disk configuration
+ *
+ * @return     disk interface, NULL on failure
+ */
+disk_ifc *file_disk_init(const file_disk_config *cfg);
+
+/**
+ * @brief      get access counters
+ */
+void file_disk_stat_get(disk_ifc *ifc, file_disk_stat *stat);
+
+/**
+ * @brief      clear access counters
+ */
+void file_disk_stat_reset(disk_ifc *ifc);
+
+#endif
@@ -0,0 +1,71 @@
+#include "host/host.h"
+#include "kernel/memory.h"
+#include "platform/clock.h"
+
+#include <malloc.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+/**
+ * Kernel and platform services the tested modules link against. The rest
+ * (malloc, free, memcpy, strlen, ...) is taken from the host C library.
+ */
+
+void *zmalloc(uint32_t size);
+
+void *zmalloc(uint32_t size) {
+    return calloc(1, size);
+}
+
+void *cell_alloc(const uint16_t size) {
+    return malloc(size);
+}
+
+void cell_free(void *ptr) {
+    free(ptr);
+}
+
+uint32_t clock_get_us(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return now.tv_sec * 1000000 + now.tv_nsec / 1000;
+}
+
+int32_t clock_get(void) {
+    return clock_get_us() / 1000;
+}
+
+uint8_t *host_file_load(const char *path, uint32_t *size) {
+    FILE *file = fopen(path, "rb");
+    if (!file) {
+        return NULL;
+    }
+
+    uint8_t *data = NULL;
+
+    if (!fseek(file, 0, SEEK_END)) {
+        long len = ftell(file);
+
+        //! empty file still gets a valid pointer
+        data = len >= 0 ? malloc(len + 1) : NULL;
+
+        rewind(file);
+
+        if (data && fread(data, 1, len, file) != (size_t) len) {
+            free(data);
+            data = NULL;
+        }
+
+        *size = len;
+    }
+
+    fclose(file);
+
+    return data;
+}
+
+uint32_t host_heap_used(void) {
+    return mallinfo2().uordblks;
+}
@@ -0,0 +1,21 @@
+#ifndef TESTS_HOST_HOST_H
+#define TESTS_HOST_HOST_H
+
+#include "common/common.h"
+
+/**
+ * @brief      read whole host file
+ *
+ * @param[in]  path  file path
+ * @param      size  file size (output)
+ *
+ * @return     file data (release with free), NULL on failure
+ */
+uint8_t *host_file_load(const char *path, uint32_t *size);
+
+/**
+ * @brief      get number of bytes allocated from host heap
+ */
+uint32_t host_heap_used(void);
+
+#endif
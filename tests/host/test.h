@@ -0,0 +1,31 @@
+#ifndef TESTS_HOST_TEST_H
+#define TESTS_HOST_TEST_H
+
+#include "lib/string.h"
+
+/**
+ * minimal host test helpers, every test is a separate program which
+ * returns non-zero if any check failed
+ */
+
+static int test_failures;
+
+/**
+ * @brief      report failed condition and keep going
+ */
+#define CHECK(COND) \
+    do { \
+        if (!(COND)) { \
+            printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #COND); \
+            test_failures++; \
+        } \
+    } while (0)
+
+/**
+ * @brief      report result, value to be returned from main
+ */
+#define TEST_RESULT(NAME) \
+    (printf("%s: %s\n", NAME, test_failures ? "FAILED" : "OK"), \
+     test_failures ? 1 : 0)
+
+#endif
@@ -0,0 +1,69 @@
+#!/bin/sh
+#
+# Build ext2 test image: mkimg.sh <layout> <image>
+#
+# File tree goes to <image>.root, tests compare file data against it.
+#   files  - 8 MiB, 1 KiB blocks: 700 KB file (double indirect blocks),
+#            30 KB file three levels deep, directory of small files
+#   tree   - 16 MiB: 8 directories of 16 subdirectories, 20 files each,
+#            one more level nested; every directory fits one block as
+#            the driver reads first directory block only
+#   groups - 512 MiB sparse image with 2048 block groups, its group
+#            descriptor table (64 KiB) doesn't fit one heap cell
+
+set -e
+
+LAYOUT=$1
+IMAGE=$2
+ROOT=$IMAGE.root
+
+rm -rf "$ROOT" "$IMAGE"
+mkdir -p "$ROOT"
+
+case $LAYOUT in
+    files)
+        seq 1 200000 | head -c 700000 > "$ROOT/big.bin"
+        mkdir -p "$ROOT/d1/d2"
+        for i in $(seq 1 40); do
+            echo "$i" > "$ROOT/d1/f$i"
+        done
+        echo "small file" > "$ROOT/d1/small.txt"
+        seq 500000 600000 | head -c 30000 > "$ROOT/d1/d2/mid.bin"
+        MKFS_OPT="-N 2048"
+        SIZE=8M
+        ;;
+    tree)
+        for t in $(seq 1 8); do
+            for d in $(seq 1 16); do
+                mkdir -p "$ROOT/t$t/d$d"
+                for f in $(seq -w 1 20); do
+                    echo "$t/$d/$f" > "$ROOT/t$t/d$d/f$f"
+                done
+            done
+        done
+        mkdir "$ROOT/t3/d5/s"
+        echo "nested" > "$ROOT/t3/d5/s/g4"
+        MKFS_OPT="-N 4096"
+        SIZE=16M
+        ;;
+    groups)
+        for d in $(seq -w 1 30); do
+            mkdir "$ROOT/d$d"
+            for f in $(seq -w 1 10); do
+                seq "$d$f" 99999 | head -c 2000 > "$ROOT/d$d/f$f"
+            done
+        done
+        MKFS_OPT="-N 16384 -g 256 -O ^meta_bg,^resize_inode"
+        SIZE=512M
+        ;;
+    *)
+        echo "unknown layout: $LAYOUT" >&2
+        exit 1
+        ;;
+esac
+
+if ! mke2fs -q -F -t ext2 -b 1024 -I 128 $MKFS_OPT -d "$ROOT" "$IMAGE" \
+    $SIZE > "$IMAGE.log" 2>&1; then
+    cat "$IMAGE.log" >&2
+    exit 1
+fi
@@ -0,0 +1,37 @@
+#include "app/terminal.h"
+#include "srv/vfs.h"
+#include "lib/string.h"
+
+static int bcstat_cmd_handler(list_ifc *args) {
+    bcache *cache = vfs_bcache();
+    if (!cache) {
+        printf("no disk mounted\n");
+        return -2;
+    }
+
+    int size = args->size(args);
+    if (size == 1) {
+        bcache_stat stat;
+
+        if (bcache_stat_get(cache, &stat)) {
+            return -3;
+        }
+
+        printf("block size: %u\n", bcache_block_size(cache));
+        printf("hits|misses|evictions|disk reads|prefetched|wasted\n");
+        printf("%u|%u|%u|%u|%u|%u\n", stat.hits, stat.misses, stat.evictions,
+            stat.disk_reads, stat.prefetched, stat.prefetch_wasted);
+
+        return 0;
+    }
+
+    if (size == 2 && !strcmp(args->get_back(args)->ptr, "reset")) {
+        bcache_stat_reset(cache);
+
+        return 0;
+    }
+
+    return -1;
+}
+
+TERMINAL_CMD(bcstat, bcstat_cmd_handler);
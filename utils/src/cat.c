@@ -1,7 +1,6 @@
 #include "app/terminal.h"
 #include "srv/vfs.h"
 #include "common/sys.h"
-#include "common/log.h"
 #include "fs/fs.h"
 
 static int cat_cmd_handler(list_ifc *args) {
@@ -38,7 +37,7 @@ static int cat_cmd_handler(list_ifc *args) {
                 printf("Not a regular file\n");
             }
         } else {
-            LOG_ERR("Failed to read file data");
+            printf("Failed to read file data\n");
         }
 
     } else {
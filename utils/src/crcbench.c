@@ -0,0 +1,93 @@
+#include "app/terminal.h"
+#include "kernel/syscall.h"
+#include "lib/crc.h"
+#include "lib/string.h"
+
+#define CRCBENCH_BLOCK      512
+#define CRCBENCH_ITERATIONS 64
+
+typedef struct crc_vector_t {
+    const char *data;
+    uint32_t    len;
+    uint16_t    crc16;
+    uint8_t     crc7;
+} crc_vector;
+
+//! CRC-16/XMODEM and CRC-7/MMC check values, CMD0 and CMD8 frames
+static const crc_vector crc_vectors[] = {
+    { "",                         0, 0x0000, 0x00 },
+    { "123456789",                9, 0x31c3, 0x75 },
+    { "\x40\x00\x00\x00\x00",     5, 0x1168, 0x4a },
+    { "\x48\x00\x00\x01\xaa",     5, 0x34d4, 0x43 },
+};
+
+#define CRC_VECTOR_COUNT (sizeof(crc_vectors) / sizeof(crc_vectors[0]))
+
+static int crcbench_check(void) {
+    int failed = 0;
+
+    for (uint32_t i = 0; i < CRC_VECTOR_COUNT; i++) {
+        const crc_vector *vec = &crc_vectors[i];
+        const uint8_t    *buf = (const uint8_t *) vec->data;
+        uint32_t          len = vec->len;
+
+        uint16_t split = crc16_update(crc16(buf, len / 2), buf + len / 2,
+            len - len / 2);
+
+        if (crc16(buf, len) != vec->crc16 || split != vec->crc16 ||
+            (crc7(buf, len) >> 1) != vec->crc7) {
+            printf("vector %u failed\n", i);
+            failed = 1;
+        }
+    }
+
+    return failed;
+}
+
+static int crcbench_cmd_handler(list_ifc *args) {
+    if (args->size(args) != 1) {
+        return -1;
+    }
+
+    if (crcbench_check()) {
+        return 0;
+    }
+
+    uint8_t *buf = malloc(CRCBENCH_BLOCK);
+    if (!buf) {
+        printf("Out of memory\n");
+        return 0;
+    }
+
+    for (uint32_t i = 0; i < CRCBENCH_BLOCK; i++) {
+        buf[i] = i * 7;
+    }
+
+    volatile uint16_t sink16 = 0;
+    volatile uint8_t  sink7  = 0;
+
+    uint32_t start = cycles();
+    for (uint32_t i = 0; i < CRCBENCH_ITERATIONS; i++) {
+        sink16 ^= crc16(buf, CRCBENCH_BLOCK);
+    }
+    uint32_t crc16_cycles = (cycles() - start) / CRCBENCH_ITERATIONS;
+
+    start = cycles();
+    for (uint32_t i = 0; i < CRCBENCH_ITERATIONS; i++) {
+        sink7 ^= crc7(buf, 5);
+    }
+    uint32_t crc7_cycles = (cycles() - start) / CRCBENCH_ITERATIONS;
+
+    (void) sink16;
+    (void) sink7;
+
+    free(buf);
+
+    printf("vectors ok, CRC_TABLES=%u\n", CRC_TABLES);
+    printf("crc16 %u B: %u cycles\n", CRCBENCH_BLOCK, crc16_cycles);
+    printf("crc7  5 B: %u cycles\n", crc7_cycles);
+
+    return 0;
+}
+
+TERMINAL_CMD(crcbench, crcbench_cmd_handler);
@@ -0,0 +1,95 @@
+#include "app/terminal.h"
+#include "driver/ram_disk.h"
+#include "driver/bcache.h"
+#include "kernel/syscall.h"
+#include "platform/clock.h"
+#include "lib/string.h"
+
+#define DBENCH_CACHE_BLOCK 0x400
+#define DBENCH_CACHE_SLOTS 0x08
+
+static void dbench_report(const char *name, uint32_t bytes, int32_t elapsed) {
+    printf("%s: %u bytes in %d ms: %u B/s\n", name, bytes, elapsed,
+        elapsed ? bytes * 1000 / (uint32_t) elapsed : 0);
+}
+
+/**
+ * @brief      sequential read of RAM disk: raw blocks, then through block
+ *             cache (cold and warm pass)
+ *
+ * Cache passes cover at most as many cache blocks as the cache has slots,
+ * so the warm pass is served from the cache.
+ */
+static int dbench_cmd_handler(list_ifc *args) {
+    int size = args->size(args);
+    if (size != 2 && size != 3) {
+        return -1;
+    }
+
+    const list_node *node = args->get_front(args)->nxt;
+
+    int blocks = atoi(node->ptr);
+    if (blocks <= 0) {
+        return -1;
+    }
+
+    int latency = size == 3 ? atoi(node->nxt->ptr) : 0;
+    if (latency < 0) {
+        return -1;
+    }
+
+    ram_disk_config cfg = {
+        .image            = NULL,
+        .blocks           = blocks,
+        .read_latency_us  = latency,
+        .write_latency_us = latency,
+    };
+
+    disk_ifc *disk = ram_disk_init(&cfg);
+    if (!disk) {
+        printf("Out of memory\n");
+        return 0;
+    }
+
+    uint8_t buf[RAM_DISK_BLOCK_SIZE];
+    uint32_t bytes = blocks * RAM_DISK_BLOCK_SIZE;
+
+    int32_t start = clock_get();
+    for (int blk = 0; blk < blocks; blk++) {
+        disk->read(disk, blk, buf);
+    }
+    dbench_report("raw", bytes, clock_get() - start);
+
+    bcache *cache = bcache_create(disk, DBENCH_CACHE_BLOCK, DBENCH_CACHE_SLOTS, 0);
+    if (cache) {
+        uint32_t step = DBENCH_CACHE_BLOCK / RAM_DISK_BLOCK_SIZE;
+
+        uint32_t cached = blocks / step;
+        if (cached > DBENCH_CACHE_SLOTS) {
+            cached = DBENCH_CACHE_SLOTS;
+        }
+        cached *= step;
+
+        for (int pass = 0; pass < 2; pass++) {
+            start = clock_get();
+            for (uint32_t blk = 0; blk < cached; blk += step) {
+                bcache_put(cache, bcache_get(cache, blk));
+            }
+            dbench_report(pass ? "cache warm" : "cache cold",
+                cached * RAM_DISK_BLOCK_SIZE, clock_get() - start);
+        }
+
+        bcache_stat stat;
+        bcache_stat_get(cache, &stat);
+        printf("hits %u, misses %u, disk reads %u\n", stat.hits, stat.misses,
+            stat.disk_reads);
+
+        bcache_destroy(cache);
+    }
+
+    disk->destroy(disk);
+
+    return 0;
+}
+
+TERMINAL_CMD(dbench, dbench_cmd_handler);
@@ -0,0 +1,131 @@
+#include "app/terminal.h"
+#include "srv/vfs.h"
+#include "common/sys.h"
+#include "platform/clock.h"
+#include "fs/fs.h"
+
+#define FBENCH_DEPTH_MAX 4
+
+/**
+ * @brief      read whole file keeping `depth` read requests in flight
+ *
+ * @return     bytes read, otherwise negative
+ */
+static int fbench_read(int fd, uint32_t depth) {
+    vfs_rw_req req = {
+        .fd   = fd,
+        .size = VFS_BUF_MAX,
+    };
+
+    char *buf = malloc(VFS_BUF_MAX);
+    if (!buf) {
+        return -1;
+    }
+
+    vfs_reply reply;
+
+    int ids[FBENCH_DEPTH_MAX];
+    uint32_t head = 0;
+    uint32_t tail = 0;
+
+    int total = 0;
+    int eof   = 0;
+
+    while (!eof || head != tail) {
+        //! keep the pipeline full until end of file
+        while (!eof && head - tail < depth) {
+            int id = vfs_submit(VFS_READ, &req, sizeof(vfs_rw_req));
+            if (id < 0) {
+                eof = 1;
+                total = -1;
+                break;
+            }
+
+            ids[head++ % FBENCH_DEPTH_MAX] = id;
+        }
+
+        if (head == tail) {
+            break;
+        }
+
+        int ret = vfs_complete(ids[tail++ % FBENCH_DEPTH_MAX], &reply, buf, VFS_BUF_MAX);
+        if (ret < 0) {
+            //! replies still in flight go away with the session
+            vfs_session_close();
+            total = -1;
+            break;
+        }
+
+        if (reply.ret <= 0) {
+            if (reply.ret < 0) {
+                total = -1;
+            }
+
+            eof = 1;
+            continue;
+        }
+
+        if (total >= 0) {
+            total += reply.ret;
+        }
+    }
+
+    free(buf);
+
+    return total;
+}
+
+static int fbench_cmd_handler(list_ifc *args) {
+    int size = args->size(args);
+    if (size != 2 && size != 3) {
+        return -1;
+    }
+
+    const list_node *node = args->get_front(args)->nxt;
+
+    char *path = node->ptr;
+    if (strsize(path) > VFS_BUF_MAX - strlen(fs_current_path_get())) {
+        return -2;
+    }
+
+    uint32_t depth = 1;
+    if (size == 3) {
+        int value = atoi((char *) node->nxt->ptr);
+        if (value <= 0 || value > FBENCH_DEPTH_MAX) {
+            return -1;
+        }
+
+        depth = value;
+    }
+
+    char path_buf[VFS_BUF_MAX + 1];
+    snprintf(path_buf, VFS_BUF_MAX, "%s/%s", fs_current_path_get(), path);
+
+    normalize_path(path_buf);
+
+    int fd = fopen(path_buf);
+    if (fd <= 0) {
+        printf("Not found\n");
+        return 0;
+    }
+
+    int32_t start = clock_get();
+
+    int bytes = fbench_read(fd, depth);
+
+    int32_t elapsed = clock_get() - start;
+
+    fclose(fd);
+
+    if (bytes < 0) {
+        printf("Failed to read file data\n");
+        return 0;
+    }
+
+    printf("%d bytes in %d ms, depth %d: %d B/s\n", bytes, elapsed, depth,
+        elapsed ? (int) ((uint32_t) bytes * 1000 / elapsed) : 0);
+
+    return 0;
+}
+
+TERMINAL_CMD(fbench, fbench_cmd_handler);
@@ -0,0 +1,72 @@
+#include "app/terminal.h"
+#include "kernel/syscall.h"
+#include "lib/format.h"
+#include "lib/string.h"
+
+#define FMTBENCH_ITERATIONS 100
+
+#define FMTBENCH_LINE_MAX   96
+
+/**
+ * @brief      sink which only counts output (formatting cost alone)
+ */
+static void fmtbench_null_write(fmt_sink *sink, const char *data, uint32_t len) {
+    (void) sink;
+    (void) data;
+    (void) len;
+}
+
+/**
+ * @brief      average cycles per line, counter read overhead excluded
+ */
+static uint32_t fmtbench_avg(uint32_t start, uint32_t end, uint32_t overhead) {
+    uint32_t elapsed = end - start;
+
+    elapsed = elapsed > overhead ? elapsed - overhead : 0;
+
+    return elapsed / FMTBENCH_ITERATIONS;
+}
+
+static int fmtbench_cmd_handler(list_ifc *args) {
+    if (args->size(args) != 1) {
+        return -1;
+    }
+
+    char     line[FMTBENCH_LINE_MAX];
+    fmt_sink null_sink = {
+        .write = fmtbench_null_write,
+    };
+
+    uint32_t start    = cycles();
+    uint32_t overhead = cycles() - start;
+
+    start = cycles();
+    for (uint32_t i = 0; i < FMTBENCH_ITERATIONS; i++) {
+        snprintf(line, sizeof(line), "[ERROR] %s::%s():%d reply: %d",
+            __FILE__, __func__, __LINE__, -(int) i);
+    }
+    printf("log  buffer: %d cycles\n", fmtbench_avg(start, cycles(), overhead));
+
+    start = cycles();
+    for (uint32_t i = 0; i < FMTBENCH_ITERATIONS; i++) {
+        snprintf(line, sizeof(line), "r%d = 0x%08x psr = 0x%08x",
+            i & 0xf, i * 2654435761u, i);
+    }
+    printf("hex  buffer: %d cycles\n", fmtbench_avg(start, cycles(), overhead));
+
+    start = cycles();
+    for (uint32_t i = 0; i < FMTBENCH_ITERATIONS; i++) {
+        snprintf(line, sizeof(line), "%s/%s", "/mnt/sd/some/dir", "file.txt");
+    }
+    printf("path buffer: %d cycles\n", fmtbench_avg(start, cycles(), overhead));
+
+    start = cycles();
+    for (uint32_t i = 0; i < FMTBENCH_ITERATIONS; i++) {
+        format(&null_sink, "%d|%u|%x|%08X", -(int) i, i, i, i);
+    }
+    printf("int  null  : %d cycles\n", fmtbench_avg(start, cycles(), overhead));
+
+    return 0;
+}
+
+TERMINAL_CMD(fmtbench, fmtbench_cmd_handler);
@@ -0,0 +1,38 @@
+#include "app/terminal.h"
+#include "arch/handler.h"
+#include "lib/string.h"
+
+static const char *isrstat_names[ISR_ID_MAX] = {
+    [ISR_SYSTICK] = "systick",
+    [ISR_USART]   = "usart",
+    [ISR_SPI_DMA] = "spi_dma",
+};
+
+static int isrstat_cmd_handler(list_ifc *args) {
+    int size = args->size(args);
+    if (size == 1) {
+        isr_stat stat;
+
+        printf("isr|count|max\n");
+
+        for (uint32_t id = 0; id < ISR_ID_MAX; id++) {
+            if (isr_stat_get(id, &stat)) {
+                continue;
+            }
+
+            printf("%s|%d|%d\n", isrstat_names[id], stat.count, stat.max);
+        }
+
+        return 0;
+    }
+
+    if (size == 2 && !strcmp(args->get_back(args)->ptr, "reset")) {
+        isr_stat_reset();
+
+        return 0;
+    }
+
+    return -1;
+}
+
+TERMINAL_CMD(isrstat, isrstat_cmd_handler);
@@ -2,7 +2,6 @@
 #include "lib/string.h"
 #include "kernel/syscall.h"
 #include "common/sys.h"
-#include "common/log.h"
 
 #define LED_CMD_ENABLE  "enable"
 #define LED_CMD_DISABLE "disable"
@@ -16,7 +15,7 @@ static int led_cmd_handler(list_ifc *args) {
 
     const void *conn =  connect(LED_PORT, 0);
     if (!conn) {
-        LOG_ERR("Failed to connect to led socket\n");
+        printf("Failed to connect to led socket\n");
         return -1;
     }
 
@@ -33,7 +32,7 @@ static int led_cmd_handler(list_ifc *args) {
     if (str) {
         ret = write(conn, str, strsize(str));
         if (ret != strsize(str)) {
-            LOG_ERR("Error writing socket: %d", ret);
+            printf("Error writing socket: %d\n", ret);
             goto exit;
         }
 
@@ -41,12 +40,12 @@ static int led_cmd_handler(list_ifc *args) {
 
         ret = timed_read(conn, (char*)&reply, sizeof(int32_t), 500);
         if (ret != sizeof(int32_t)) {
-            LOG_ERR("Error reading socket: %d", ret);
+            printf("Error reading socket: %d\n", ret);
             goto exit;
         }
 
         if (reply != 0) {
-            LOG_ERR("Error reply received: %d", reply);
+            printf("Error reply received: %d\n", reply);
             goto exit;
         }
 
@@ -1,7 +1,6 @@
 #include "app/terminal.h"
 #include "srv/vfs.h"
 #include "common/sys.h"
-#include "common/log.h"
 
 #define IO_BUF_SIZE 64
 
@@ -39,7 +38,7 @@ static int ls_cmd_handler(list_ifc *args) {
                 printf("Not a dir\n");
             }
         } else {
-            LOG_ERR("Failed to read file data");
+            printf("Failed to read file data\n");
         }
 
     } else {
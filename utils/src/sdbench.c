@@ -0,0 +1,120 @@
+#ifdef SD_EMU
+
+#include "app/terminal.h"
+#include "driver/ram_disk.h"
+#include "driver/sd_emu.h"
+#include "driver/sd_spi.h"
+#include "kernel/syscall.h"
+#include "lib/string.h"
+
+#define SDBENCH_BLOCKS    0x20
+#define SDBENCH_RUN       0x04
+#define SDBENCH_ACCESS    0x02
+#define SDBENCH_BUSY      0x04
+#define SDBENCH_POLLS     0x02
+
+static void sdbench_report(const char *name, uint32_t start, uint32_t blocks,
+    spi_iface *emu, sd_emu_stat *last) {
+    uint32_t elapsed = cycles() - start;
+
+    sd_emu_stat stat;
+    sd_emu_stat_get(emu, &stat);
+
+    printf("%s: %u cycles/block, %u commands, %u bytes/block\n", name,
+        elapsed / blocks, stat.commands - last->commands,
+        (stat.bytes - last->bytes) / blocks);
+
+    memcpy(last, &stat, sizeof(sd_emu_stat));
+}
+
+/**
+ * @brief      run SD driver against emulated card on a RAM disk
+ */
+static int sdbench_cmd_handler(list_ifc *args) {
+    if (args->size(args) != 1) {
+        return -1;
+    }
+
+    ram_disk_config disk_cfg = {
+        .image            = NULL,
+        .blocks           = SDBENCH_BLOCKS,
+        .read_latency_us  = 0,
+        .write_latency_us = 0,
+    };
+
+    disk_ifc *disk = ram_disk_init(&disk_cfg);
+    if (!disk) {
+        printf("Out of memory\n");
+        return 0;
+    }
+
+    sd_emu_config emu_cfg = {
+        .disk           = disk,
+        .cmd_latency_us = 0,
+        .access_bytes   = SDBENCH_ACCESS,
+        .busy_bytes     = SDBENCH_BUSY,
+        .init_polls     = SDBENCH_POLLS,
+    };
+
+    spi_iface *emu = sd_emu_init(&emu_cfg);
+    if (!emu) {
+        disk->destroy(disk);
+        printf("Out of memory\n");
+        return 0;
+    }
+
+    sd_emu_stat last;
+    memset(&last, 0, sizeof(sd_emu_stat));
+
+    uint32_t start = cycles();
+
+    disk_ifc *sd = sd_spi_attach(emu);
+    if (!sd) {
+        printf("SD init failed\n");
+        goto end;
+    }
+
+    sdbench_report("init  ", start, 1, emu, &last);
+
+    uint8_t *buf = malloc(SDBENCH_RUN * RAM_DISK_BLOCK_SIZE);
+    if (buf) {
+        start = cycles();
+        for (uint32_t blk = 0; blk < SDBENCH_BLOCKS; blk++) {
+            sd->read(sd, blk, buf);
+        }
+        sdbench_report("read  ", start, SDBENCH_BLOCKS, emu, &last);
+
+        start = cycles();
+        for (uint32_t blk = 0; blk < SDBENCH_BLOCKS; blk += SDBENCH_RUN) {
+            sd->read_blocks(sd, blk, SDBENCH_RUN, buf);
+        }
+        sdbench_report("read 4", start, SDBENCH_BLOCKS, emu, &last);
+
+        start = cycles();
+        for (uint32_t blk = 0; blk < SDBENCH_BLOCKS; blk++) {
+            sd->write(sd, blk, buf);
+        }
+        sdbench_report("write ", start, SDBENCH_BLOCKS, emu, &last);
+
+        start = cycles();
+        for (uint32_t blk = 0; blk < SDBENCH_BLOCKS; blk += SDBENCH_RUN) {
+            sd->write_blocks(sd, blk, SDBENCH_RUN, buf);
+        }
+        sdbench_report("write4", start, SDBENCH_BLOCKS, emu, &last);
+
+        free(buf);
+    }
+
+    sd->destroy(sd);
+
+    end:
+
+    emu->destroy(emu);
+    disk->destroy(disk);
+
+    return 0;
+}
+
+TERMINAL_CMD(sdbench, sdbench_cmd_handler);
+
+#endif
@@ -0,0 +1,36 @@
+#include "app/terminal.h"
+#include "kernel/socket.h"
+#include "kernel/syscall.h"
+#include "lib/list.h"
+
+static int sockstat_cmd_handler(list_ifc *args) {
+    int size = args->size(args);
+    if (size == 1) {
+        socket_stat stat;
+
+        printf("port|acc/dec|in/out|rx/tx hw|backlog/hw\n");
+
+        for (uint32_t port = 0; port < SOCKET_PORT_MAX; port++) {
+            if (socket_stat_get(port, &stat)) {
+                continue;
+            }
+
+            printf("%d|%d/%d|%d/%d|%d/%d|%d/%d\n",
+                port,
+                stat.accepted,
+                stat.declined,
+                stat.bytes_in,
+                stat.bytes_out,
+                stat.rx_high_water,
+                stat.tx_high_water,
+                stat.backlog,
+                stat.backlog_high_water);
+        }
+
+        return 0;
+    }
+
+    return -1;
+}
+
+TERMINAL_CMD(sockstat, sockstat_cmd_handler);
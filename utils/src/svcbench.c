@@ -0,0 +1,136 @@
+#include "app/terminal.h"
+#include "kernel/syscall.h"
+#include "kernel/thread.h"
+#include "lib/string.h"
+#include "platform/clock.h"
+
+#define SVCBENCH_ITERATIONS 100
+
+/**
+ * @brief      average cycles per call, counter read overhead excluded
+ */
+static uint32_t svcbench_avg(uint32_t start, uint32_t end, uint32_t overhead) {
+    uint32_t elapsed = end - start;
+
+    elapsed = elapsed > overhead ? elapsed - overhead : 0;
+
+    return elapsed / SVCBENCH_ITERATIONS;
+}
+
+static int svcbench_cmd_handler(list_ifc *args) {
+    if (args->size(args) != 1) {
+        return -1;
+    }
+
+    uint32_t start    = cycles();
+    uint32_t overhead = cycles() - start;
+
+    char byte = 0;
+
+    //! invalid descriptor: measures the trap path, not the IO
+    rw_request rw_req = {
+        .result    = 0,
+        .dest      = NULL,
+        .data      = &byte,
+        .data_size = sizeof(byte),
+    };
+
+    thread_signal_request signal_req = {
+        .object    = NULL,
+    };
+
+    start = cycles();
+    for (uint32_t i = 0; i < SVCBENCH_ITERATIONS; i++) {
+        sv_call(SVC_READ, &rw_req);
+    }
+    printf("read   struct: %d cycles\n", svcbench_avg(start, cycles(), overhead));
+
+    start = cycles();
+    for (uint32_t i = 0; i < SVCBENCH_ITERATIONS; i++) {
+        read(NULL, &byte, sizeof(byte));
+    }
+    printf("read   fast  : %d cycles\n", svcbench_avg(start, cycles(), overhead));
+
+    start = cycles();
+    for (uint32_t i = 0; i < SVCBENCH_ITERATIONS; i++) {
+        sv_call(SVC_WRITE, &rw_req);
+    }
+    printf("write  struct: %d cycles\n", svcbench_avg(start, cycles(), overhead));
+
+    start = cycles();
+    for (uint32_t i = 0; i < SVCBENCH_ITERATIONS; i++) {
+        write(NULL, &byte, sizeof(byte));
+    }
+    printf("write  fast  : %d cycles\n", svcbench_avg(start, cycles(), overhead));
+
+    start = cycles();
+    for (uint32_t i = 0; i < SVCBENCH_ITERATIONS; i++) {
+        sv_call(SVC_WAKEUP, &signal_req);
+    }
+    printf("signal struct: %d cycles\n", svcbench_avg(start, cycles(), overhead));
+
+    start = cycles();
+    for (uint32_t i = 0; i < SVCBENCH_ITERATIONS; i++) {
+        signal(NULL);
+    }
+    printf("signal fast  : %d cycles\n", svcbench_avg(start, cycles(), overhead));
+
+    //! yield and sleep enter the scheduler: time of threads that are
+    //! ready at the same priority is included
+    start = cycles();
+    for (uint32_t i = 0; i < SVCBENCH_ITERATIONS; i++) {
+        thread_yield();
+        sv_call(SVC_RESCHEDULE, NULL);
+    }
+    printf("yield  struct: %d cycles\n", svcbench_avg(start, cycles(), overhead));
+
+    start = cycles();
+    for (uint32_t i = 0; i < SVCBENCH_ITERATIONS; i++) {
+        yield();
+    }
+    printf("yield  fast  : %d cycles\n", svcbench_avg(start, cycles(), overhead));
+
+    start = cycles();
+    for (uint32_t i = 0; i < SVCBENCH_ITERATIONS; i++) {
+        thread_delay(0);
+        sv_call(SVC_RESCHEDULE, NULL);
+    }
+    printf("sleep  struct: %d cycles\n", svcbench_avg(start, cycles(), overhead));
+
+    start = cycles();
+    for (uint32_t i = 0; i < SVCBENCH_ITERATIONS; i++) {
+        sleep(0);
+    }
+    printf("sleep  fast  : %d cycles\n", svcbench_avg(start, cycles(), overhead));
+
+    //! condition already changed: trap path without suspending, the
+    //! structure call always suspends and needs another thread to wake it
+    uint32_t word = 1;
+
+    start = cycles();
+    for (uint32_t i = 0; i < SVCBENCH_ITERATIONS; i++) {
+        wait_cond(&word, &word, 0);
+    }
+    printf("wait   fast  : %d cycles\n", svcbench_avg(start, cycles(), overhead));
+
+    //! time page reads, no trap involved
+    volatile uint32_t sink = 0;
+
+    start = cycles();
+    for (uint32_t i = 0; i < SVCBENCH_ITERATIONS; i++) {
+        sink += clock_get();
+    }
+    printf("clock_get    : %d cycles\n", svcbench_avg(start, cycles(), overhead));
+
+    start = cycles();
+    for (uint32_t i = 0; i < SVCBENCH_ITERATIONS; i++) {
+        sink += clock_get_us();
+    }
+    printf("clock_get_us : %d cycles\n", svcbench_avg(start, cycles(), overhead));
+
+    (void) sink;
+
+    return 0;
+}
+
+TERMINAL_CMD(svcbench, svcbench_cmd_handler);
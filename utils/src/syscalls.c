@@ -0,0 +1,69 @@
+#include "app/terminal.h"
+#include "kernel/syscall.h"
+#include "lib/string.h"
+
+#ifdef SVC_PROFILE
+
+/**
+ * @brief      get average cycles per call
+ *
+ * NOTE: firmware isn't linked with libgcc, so there is no 64-bit
+ *       division: both values are scaled down until the total fits
+ */
+static uint32_t syscalls_avg(const svc_profile *profile) {
+    uint64_t cycles = profile->cycles;
+    uint32_t calls  = profile->calls;
+
+    while (cycles >> 32) {
+        cycles >>= 1;
+        calls  >>= 1;
+    }
+
+    return calls ? (uint32_t) cycles / calls : (uint32_t) cycles;
+}
+
+static void syscalls_print(int fast, uint32_t count) {
+    svc_profile profile;
+
+    for (uint32_t code = 0; code < count; code++) {
+        if (svc_profile_get(fast, code, &profile)) {
+            break;
+        }
+
+        if (!profile.calls) {
+            continue;
+        }
+
+        printf("%c|0x%x|%u|%u|%u\n",
+            fast ? 'F' : 'S',
+            code,
+            profile.calls,
+            syscalls_avg(&profile),
+            profile.max);
+    }
+}
+
+static int syscalls_cmd_handler(list_ifc *args) {
+    int size = args->size(args);
+    if (size == 1) {
+        printf("abi|code|calls|avg|max\n");
+
+        //! upper bound: lookup fails past the last code
+        syscalls_print(0, 0x100);
+        syscalls_print(1, SVC_FAST_COUNT);
+
+        return 0;
+    }
+
+    if (size == 2 && !strcmp(args->get_back(args)->ptr, "reset")) {
+        svc_profile_reset();
+
+        return 0;
+    }
+
+    return -1;
+}
+
+TERMINAL_CMD(syscalls, syscalls_cmd_handler);
+
+#endif